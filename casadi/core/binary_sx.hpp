@@ -28,6 +28,7 @@
 
 #include "sx_node.hpp"
 #include "serializing_stream.hpp"
+#include "global_options.hpp"
 
 /// \cond INTERNAL
 namespace casadi {
@@ -41,7 +42,7 @@ class BinarySX : public SXNode {
 
     /** \brief  Constructor is private, use "create" below */
     BinarySX(unsigned char op, const SXElem& dep0, const SXElem& dep1) :
-        op_(op), dep0_(dep0), dep1_(dep1) {}
+        op_(op), hashed_(false), dep0_(dep0), dep1_(dep1) {}
 
   public:
 
@@ -54,6 +55,15 @@ class BinarySX : public SXNode {
         double ret_val;
         casadi_math<double>::fun(op, dep0_val, dep1_val, ret_val);
         return ret_val;
+      } else if (GlobalOptions::hash_consing) {
+        // Reuse an identical expression, if any
+        SXElem ret;
+        if (hash_cons_find(op, dep0.get(), dep1.get(), operation_checker<CommChecker>(op),
+                           ret)) return ret;
+        BinarySX* r = new BinarySX(op, dep0, dep1);
+        r->hashed_ = true;
+        hash_cons_insert(r, op, dep0.get(), dep1.get());
+        return SXElem::create(r);
       } else {
         // Expression containing free variables
         return SXElem::create(new BinarySX(op, dep0, dep1));
@@ -65,10 +75,18 @@ class BinarySX : public SXNode {
     can cause stack overflow due to recursive calling.
     */
     ~BinarySX() override {
+      hash_cons_release();
       safe_delete(dep0_.assignNoDelete(casadi_limits<SXElem>::nan));
       safe_delete(dep1_.assignNoDelete(casadi_limits<SXElem>::nan));
     }
 
+    void hash_cons_release() override {
+      if (hashed_) {
+        hashed_ = false;
+        hash_cons_erase(this, op_, dep0_.get(), dep1_.get());
+      }
+    }
+
     // Class name
     std::string class_name() const override {return "BinarySX";}
 
@@ -107,6 +125,9 @@ class BinarySX : public SXNode {
     /** \brief  The binary operation as an 1 byte integer (allows 256 values) */
     unsigned char op_;
 
+    /** \brief  Registered in the hash-consing table */
+    bool hashed_;
+
     /** \brief  The dependencies of the node */
     SXElem dep0_, dep1_;
 
@@ -67,6 +67,7 @@ namespace casadi {
     sz += n_dims; // starts
     sz += n_dims; // index
     sz += n_dims+1; // coeff_offset
+    sz += n_dims; // low
     return sz;
   }
 
@@ -157,9 +158,10 @@ namespace casadi {
           casadi_int m,
           const std::vector<casadi_int>& lookup_mode) :
           BSplineCommon(knots, offset, degree, m, lookup_mode), coeffs_(coeffs) {
-    casadi_assert_dev(x.numel()==degree.size());
+    casadi_assert_dev(x.numel()==degree.size() || x.size1()==degree.size());
     set_dep(x);
-    set_sparsity(Sparsity::dense(m, 1));
+    // One column per point
+    set_sparsity(Sparsity::dense(m, x.numel()/degree.size()));
   }
 
   BSplineParametric::BSplineParametric(const MX& x,
@@ -170,9 +172,10 @@ namespace casadi {
           casadi_int m,
           const std::vector<casadi_int>& lookup_mode) :
           BSplineCommon(knots, offset, degree, m, lookup_mode) {
-    casadi_assert_dev(x.numel()==degree.size());
+    casadi_assert_dev(x.numel()==degree.size() || x.size1()==degree.size());
     set_dep(x, coeffs);
-    set_sparsity(Sparsity::dense(m, 1));
+    // One column per point
+    set_sparsity(Sparsity::dense(m, x.numel()/degree.size()));
   }
 
   MX BSpline::create(const MX& x, const std::vector< std::vector<double> >& knots,
@@ -245,37 +248,95 @@ namespace casadi {
   void BSplineCommon::ad_forward(const std::vector<std::vector<MX> >& fseed,
                           std::vector<std::vector<MX> >& fsens) const {
     MX J = jac_cached();
+    casadi_int n = size2();
 
     for (casadi_int d=0; d<fsens.size(); ++d) {
-      fsens[d][0] = mtimes(J, fseed[d][0]);
+      if (n==1) {
+        fsens[d][0] = mtimes(J, fseed[d][0]);
+      } else {
+        // Jacobian blocks hold the partial derivatives for all points
+        fsens[d][0] = MX::zeros(m_, n);
+        for (casadi_int k=0; k<degree_.size(); ++k) {
+          fsens[d][0] += J(Slice(), Slice(k*n, (k+1)*n))
+            * repmat(fseed[d][0](k, Slice()), m_, 1);
+        }
+      }
     }
   }
 
   void BSplineCommon::ad_reverse(const std::vector<std::vector<MX> >& aseed,
                           std::vector<std::vector<MX> >& asens) const {
-    MX JT = jac_cached().T();
-    for (casadi_int d=0; d<aseed.size(); ++d) {
-      asens[d][0] += mtimes(JT, aseed[d][0]);
+    casadi_int n = size2();
+    if (n==1) {
+      MX JT = jac_cached().T();
+      for (casadi_int d=0; d<aseed.size(); ++d) {
+        asens[d][0] += mtimes(JT, aseed[d][0]);
+      }
+    } else {
+      MX J = jac_cached();
+      for (casadi_int d=0; d<aseed.size(); ++d) {
+        std::vector<MX> rows;
+        for (casadi_int k=0; k<degree_.size(); ++k) {
+          rows.push_back(sum1(J(Slice(), Slice(k*n, (k+1)*n)) * aseed[d][0]));
+        }
+        asens[d][0] += vertcat(rows);
+      }
     }
   }
 
+  int BSplineCommon::sp_forward(const bvec_t** arg, bvec_t** res,
+      casadi_int* iw, bvec_t* w) const {
+    casadi_int n_dims = degree_.size();
+    // Parametric coefficients affect all points
+    bvec_t all_depend(0);
+    if (n_dep()>1) {
+      for (casadi_int i=0; i<dep(1).nnz(); ++i) all_depend |= arg[1][i];
+    }
+    // Each point only depends on its own position
+    for (casadi_int p=0; p<size2(); ++p) {
+      bvec_t dep_p = all_depend;
+      for (casadi_int k=0; k<n_dims; ++k) dep_p |= arg[0][p*n_dims+k];
+      std::fill(res[0]+p*m_, res[0]+(p+1)*m_, dep_p);
+    }
+    return 0;
+  }
+
+  int BSplineCommon::sp_reverse(bvec_t** arg, bvec_t** res,
+      casadi_int* iw, bvec_t* w) const {
+    casadi_int n_dims = degree_.size();
+    bvec_t all_depend(0);
+    for (casadi_int p=0; p<size2(); ++p) {
+      bvec_t dep_p(0);
+      for (casadi_int i=0; i<m_; ++i) {
+        dep_p |= res[0][p*m_+i];
+        res[0][p*m_+i] = 0;
+      }
+      for (casadi_int k=0; k<n_dims; ++k) arg[0][p*n_dims+k] |= dep_p;
+      all_depend |= dep_p;
+    }
+    if (n_dep()>1) {
+      for (casadi_int i=0; i<dep(1).nnz(); ++i) arg[1][i] |= all_depend;
+    }
+    return 0;
+  }
+
   int BSpline::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
     if (!res[0]) return 0;
 
-    casadi_clear(res[0], m_);
-    casadi_nd_boor_eval(res[0], degree_.size(), get_ptr(knots_), get_ptr(offset_),
-      get_ptr(degree_), get_ptr(strides_), get_ptr(coeffs_), m_, arg[0], get_ptr(lookup_mode_),
-      iw, w);
+    casadi_clear(res[0], nnz());
+    casadi_nd_boor_eval_batch(res[0], degree_.size(), get_ptr(knots_), get_ptr(offset_),
+      get_ptr(degree_), get_ptr(strides_), get_ptr(coeffs_), m_, arg[0], size2(),
+      get_ptr(lookup_mode_), iw, w);
     return 0;
   }
 
   int BSplineParametric::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
     if (!res[0]) return 0;
 
-    casadi_clear(res[0], m_);
-    casadi_nd_boor_eval(res[0], degree_.size(), get_ptr(knots_), get_ptr(offset_),
-      get_ptr(degree_), get_ptr(strides_), arg[1], m_, arg[0], get_ptr(lookup_mode_),
-      iw, w);
+    casadi_clear(res[0], nnz());
+    casadi_nd_boor_eval_batch(res[0], degree_.size(), get_ptr(knots_), get_ptr(offset_),
+      get_ptr(degree_), get_ptr(strides_), arg[1], m_, arg[0], size2(),
+      get_ptr(lookup_mode_), iw, w);
     return 0;
   }
 
@@ -284,15 +345,25 @@ namespace casadi {
                       const std::vector<casadi_int>& res) const {
     casadi_int n_dims = offset_.size()-1;
 
+    casadi_int n = size2();
+
     g.add_auxiliary(CodeGenerator::AUX_ND_BOOR_EVAL);
     g.add_auxiliary(CodeGenerator::AUX_FILL);
-    g << g.clear(g.work(res[0], m_), m_) << "\n";
+    g << g.clear(g.work(res[0], m_*n), m_*n) << "\n";
 
     // Input and output buffers
-    g << "CASADI_PREFIX(nd_boor_eval)(" << g.work(res[0], m_) << "," << n_dims << ","
-      << g.constant(knots_) << "," << g.constant(offset_) << "," <<  g.constant(degree_)
-      << "," << g.constant(strides_) << "," << generate(g, arg) << "," << m_  << ","
-      << g.work(arg[0], n_dims) << "," <<  g.constant(lookup_mode_) << ", iw, w);\n";
+    if (n==1) {
+      g << "CASADI_PREFIX(nd_boor_eval)(" << g.work(res[0], m_) << "," << n_dims << ","
+        << g.constant(knots_) << "," << g.constant(offset_) << "," <<  g.constant(degree_)
+        << "," << g.constant(strides_) << "," << generate(g, arg) << "," << m_  << ","
+        << g.work(arg[0], n_dims) << "," <<  g.constant(lookup_mode_) << ", iw, w);\n";
+    } else {
+      g << "CASADI_PREFIX(nd_boor_eval_batch)(" << g.work(res[0], m_*n) << "," << n_dims << ","
+        << g.constant(knots_) << "," << g.constant(offset_) << "," <<  g.constant(degree_)
+        << "," << g.constant(strides_) << "," << generate(g, arg) << "," << m_  << ","
+        << g.work(arg[0], n_dims*n) << "," << n << "," <<  g.constant(lookup_mode_)
+        << ", iw, w);\n";
+    }
   }
 
   std::string BSpline::generate(CodeGenerator& g, const std::vector<casadi_int>& arg) const {
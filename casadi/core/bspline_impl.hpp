@@ -79,7 +79,11 @@ namespace casadi {
 
     Dict opts;
     std::vector<std::string> lookup_mode;
-    for (auto e : lookup_mode_) lookup_mode.push_back(Low::lookup_mode_from_enum(e));
+    for (casadi_int k=0;k<n_dims;++k) {
+      // Negative entries point to a bucket table; rebuilt for the derivative knots
+      casadi_int e = lookup_mode_[k];
+      lookup_mode.push_back(Low::lookup_mode_from_enum(e<0 ? LOOKUP_BUCKET : e));
+    }
     opts["lookup_mode"] = lookup_mode;
     
     // Loop over dimensions
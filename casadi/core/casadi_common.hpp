@@ -150,6 +150,7 @@ namespace casadi {
   constexpr casadi_int LOOKUP_LINEAR = 0;
   constexpr casadi_int LOOKUP_EXACT = 1;
   constexpr casadi_int LOOKUP_BINARY = 2;
+  constexpr casadi_int LOOKUP_BUCKET = 3;
 
   /// String representation, any type
   template<typename T>
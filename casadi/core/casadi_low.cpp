@@ -45,6 +45,8 @@ namespace casadi {
     }
 
     lookup_mode_ = interpret_lookup_mode(lookup_mode, v.numel());
+    // No bucket table for a symbolic grid
+    if (lookup_mode_==LOOKUP_BUCKET) lookup_mode_ = LOOKUP_BINARY;
   }
 
   std::string Low::lookup_mode_from_enum(casadi_int lookup_mode) {
@@ -55,6 +57,8 @@ namespace casadi {
         return "exact";
       case LOOKUP_BINARY:
         return "binary";
+      case LOOKUP_BUCKET:
+        return "bucket";
       default:
         casadi_assert_dev(false);
     }
@@ -70,20 +74,41 @@ namespace casadi {
       return LOOKUP_LINEAR;
     } else if (lookup_mode=="exact") {
       return LOOKUP_EXACT;
+    } else if (lookup_mode=="bucket") {
+      return LOOKUP_BUCKET;
     } else {
       casadi_error("Invalid lookup mode '" + lookup_mode + "'. "
-        "Available modes: linear|binary|exact|auto");
+        "Available modes: linear|binary|exact|bucket|auto");
     }
   }
 
+  std::vector<casadi_int> Low::bucket_table(const std::vector<double>& grid,
+                                            casadi_int& max_scan) {
+    max_scan = 0;
+    casadi_int ng = grid.size();
+    if (ng<3 || !(grid.back()>grid.front())) return {};
+    // As many buckets as intervals
+    casadi_int nb = ng-1;
+    double g0 = grid.front(), dg = grid.back()-g0;
+    std::vector<casadi_int> ret(1+nb);
+    ret[0] = nb;
+    casadi_int i = 0;
+    for (casadi_int j=0; j<nb; ++j) {
+      double t = g0 + dg*static_cast<double>(j)/static_cast<double>(nb);
+      while (i<ng-2 && t>=grid[i+1]) i++;
+      ret[1+j] = i;
+      if (j>0) max_scan = std::max(max_scan, i-ret[j]);
+    }
+    max_scan = std::max(max_scan, ng-2-ret[nb]);
+    return ret;
+  }
+
   std::string Low::disp(const std::vector<std::string>& arg) const {
     return "low(" + arg.at(0) + ", " + arg.at(1) + ")";
   }
 
   int Low::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
-    for (casadi_int i=0;i<dep(1).nnz();++i) {
-      res[0][i] = casadi_low(arg[1][i], arg[0], dep(0).nnz(), lookup_mode_);
-    }
+    casadi_low_batch(res[0], arg[1], dep(1).nnz(), arg[0], dep(0).nnz(), lookup_mode_);
     return 0;
   }
 
@@ -117,12 +142,8 @@ namespace casadi {
                       const std::vector<casadi_int>& res) const {
     casadi_int n = dep(1).nnz();
     casadi_int ng = dep(0).nnz();
-    g.local("cr", "const casadi_real", "*");
-    g.local("rr", "casadi_real", "*");
-    g << "for (cr=" << g.work(arg[1], n) << ", rr=" << g.work(res[0], n);
-    g << ";cr!=" << g.work(arg[1], n) << "+" << n << ";++cr) ";
-    g << "*rr++ = ";
-    g << g.low("*cr", g.work(arg[0], ng), ng, lookup_mode_) << "\n";
+    g << g.low_batch(g.work(res[0], n), g.work(arg[1], n), n, g.work(arg[0], ng), ng,
+                     lookup_mode_) << "\n";
   }
 
   void Low::serialize_body(SerializingStream& s) const {
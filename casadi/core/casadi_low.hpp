@@ -82,6 +82,13 @@ namespace casadi {
     static casadi_int interpret_lookup_mode(const std::string& lookup_mode, casadi_int n);
     static std::string lookup_mode_from_enum(casadi_int lookup_mode);
 
+    /** \brief Bucket table for casadi_low_table
+     * Empty if the grid has fewer than three points or zero width.
+     * max_scan is the largest number of intervals scanned within a bucket.
+     */
+    static std::vector<casadi_int> bucket_table(const std::vector<double>& grid,
+                                                casadi_int& max_scan);
+
   protected:
     /** \brief Deserializing constructor */
     explicit Low(DeserializingStream& s);
@@ -44,6 +44,9 @@ namespace casadi {
     this->codegen_scalars = false;
     this->with_header = false;
     this->with_mem = false;
+    this->with_batch = false;
+    this->batch_width = 8;
+    this->batch_simd = false;
     this->with_export = true;
     this->with_import = false;
     this->include_math = true;
@@ -77,6 +80,13 @@ namespace casadi {
         this->with_header = e.second;
       } else if (e.first=="with_mem") {
         this->with_mem = e.second;
+      } else if (e.first=="with_batch") {
+        this->with_batch = e.second;
+      } else if (e.first=="batch_width") {
+        this->batch_width = e.second;
+        casadi_assert(this->batch_width>=1, "Option 'batch_width' must be positive");
+      } else if (e.first=="batch_simd") {
+        this->batch_simd = e.second;
       } else if (e.first=="with_export") {
         this->with_export = e.second;
       } else if (e.first=="with_import") {
@@ -975,6 +985,9 @@ namespace casadi {
     case AUX_MTIMES:
       this->auxiliaries << sanitize_source(casadi_mtimes_str, inst);
       break;
+    case AUX_MTIMES_DENSE:
+      this->auxiliaries << sanitize_source(casadi_mtimes_dense_str, inst);
+      break;
     case AUX_PROJECT:
       this->auxiliaries << sanitize_source(casadi_project_str, inst);
       break;
@@ -1534,6 +1547,13 @@ namespace casadi {
       + z + ", " + sparsity(sp_z) + ", " + w + ", " +  (tr ? "1" : "0") + ");";
   }
 
+  string CodeGenerator::mtimes(const string& x, casadi_int nrow_x, casadi_int ncol_x,
+                               const string& y, casadi_int ncol_y, const string& z) {
+    add_auxiliary(AUX_MTIMES_DENSE);
+    return "casadi_mtimes_dense(" + x + ", " + str(nrow_x) + ", " + str(ncol_x) + ", "
+      + y + ", " + str(ncol_y) + ", " + z + ");";
+  }
+
   void CodeGenerator::print_formatted(const string& s) {
     // Quick return if empty
     if (s.empty()) return;
@@ -1787,6 +1807,16 @@ namespace casadi {
            + d + ", " + p + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  ldl_super(const std::string& sp_a, const std::string& a,
+            const std::string& sp_lt, const std::string& lt, const std::string& d,
+            const std::string& p, const std::string& sp_super, const std::string& w,
+            const std::string& iw) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl_super(" + sp_a + ", " + a + ", " + sp_lt + ", " + lt + ", "
+           + d + ", " + p + ", " + sp_super + ", " + w + ", " + iw + ");";
+  }
+
   std::string CodeGenerator::
   ldl_solve(const std::string& x, casadi_int nrhs,
     const std::string& sp_lt, const std::string& lt, const std::string& d,
@@ -1881,6 +1911,14 @@ namespace casadi {
     return "casadi_low(" + x + ", " + grid + ", " + str(ng) + ", " + str(lookup_mode) + ");";
   }
 
+  std::string CodeGenerator::
+  low_batch(const std::string& ret, const std::string& x, casadi_int n,
+            const std::string& grid, casadi_int ng, casadi_int lookup_mode) {
+    add_auxiliary(CodeGenerator::AUX_LOW);
+    return "casadi_low_batch(" + ret + ", " + x + ", " + str(n) + ", " + grid + ", "
+           + str(ng) + ", " + str(lookup_mode) + ");";
+  }
+
   std::string CodeGenerator::
   bound_consistency(casadi_int n, const std::string& x,
     const std::string& lam, const std::string& lbx, const std::string& ubx) {
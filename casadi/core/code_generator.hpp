@@ -196,6 +196,10 @@ namespace casadi {
                        const std::string& z, const Sparsity& sp_z,
                        const std::string& w, bool tr);
 
+    /** \brief Codegen dense matrix-matrix multiplication */
+    std::string mtimes(const std::string& x, casadi_int nrow_x, casadi_int ncol_x,
+                       const std::string& y, casadi_int ncol_y, const std::string& z);
+
     /** \brief Codegen bilinear form */
     std::string bilin(const std::string& A, const Sparsity& sp_A,
                       const std::string& x, const std::string& y);
@@ -247,6 +251,13 @@ namespace casadi {
                    const std::string& d, const std::string& p,
                    const std::string& w);
 
+    /** \brief Supernodal LDL factorization */
+    std::string ldl_super(const std::string& sp_a, const std::string& a,
+                         const std::string& sp_lt, const std::string& lt,
+                         const std::string& d, const std::string& p,
+                         const std::string& sp_super, const std::string& w,
+                         const std::string& iw);
+
     /** \brief LDL solve */
     std::string ldl_solve(const std::string& x, casadi_int nrhs,
                          const std::string& sp_lt, const std::string& lt,
@@ -302,6 +313,10 @@ namespace casadi {
     std::string low(const std::string& x, const std::string& grid,
       casadi_int ng, casadi_int lookup_mode);
 
+    /** \brief low for a vector of points */
+    std::string low_batch(const std::string& ret, const std::string& x, casadi_int n,
+      const std::string& grid, casadi_int ng, casadi_int lookup_mode);
+
     /** \brief Declare a function */
     std::string declare(std::string s);
 
@@ -327,6 +342,7 @@ namespace casadi {
       AUX_MV,
       AUX_MV_DENSE,
       AUX_MTIMES,
+      AUX_MTIMES_DENSE,
       AUX_PROJECT,
       AUX_TRI_PROJECT,
       AUX_DENSIFY,
@@ -504,6 +520,15 @@ namespace casadi {
     // Should we create a memory entry point?
     bool with_mem;
 
+    // Should we create batched (structure-of-arrays) entry points?
+    bool with_batch;
+
+    // Number of points evaluated together in the batched entry points
+    casadi_int batch_width;
+
+    // Annotate the loops over points in the batched entry points with "omp simd"?
+    bool batch_simd;
+
     // Generate header file?
     bool with_header;
 
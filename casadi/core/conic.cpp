@@ -394,7 +394,13 @@ namespace casadi {
         "Print a numeric description of the problem"}},
       {"error_on_fail",
        {OT_BOOL,
-        "When the numerical process returns unsuccessfully, raise an error (default false)."}}
+        "When the numerical process returns unsuccessfully, raise an error (default false)."}},
+      {"reuse_factorization",
+       {OT_BOOL,
+        "Reuse the state of the previous call with the same memory object, "
+        "e.g. a matrix factorization, if H and A are unchanged. "
+        "The result then depends on the previous calls. Supported by qrqp, qpoases and osqp "
+        "(default false)."}}
      }
   };
 
@@ -404,6 +410,7 @@ namespace casadi {
 
     print_problem_ = false;
     error_on_fail_ = true;
+    reuse_factorization_ = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -413,6 +420,8 @@ namespace casadi {
         print_problem_ = op.second;
       } else if (op.first=="error_on_fail") {
         error_on_fail_ = op.second;
+      } else if (op.first=="reuse_factorization") {
+        reuse_factorization_ = op.second;
       }
     }
 
@@ -441,6 +450,13 @@ namespace casadi {
     m->unified_return_status = SOLVER_RET_UNKNOWN;
     m->iter_count = -1;
 
+    // No previous call
+    m->called_before = false;
+    if (reuse_factorization_) {
+      m->h_prev.resize(H_.nnz());
+      m->a_prev.resize(A_.nnz());
+    }
+
     return 0;
   }
 
@@ -477,6 +493,21 @@ namespace casadi {
     }
   }
 
+  bool Conic::reuse_factorization(ConicMemory* m, const double* h, const double* a) const {
+    if (!reuse_factorization_) return false;
+    // Compare with the previous call
+    bool same = m->called_before;
+    for (casadi_int k=0; k<H_.nnz() && same; ++k) same = m->h_prev[k]==(h ? h[k] : 0);
+    for (casadi_int k=0; k<A_.nnz() && same; ++k) same = m->a_prev[k]==(a ? a[k] : 0);
+    // Record for the next call
+    if (!same) {
+      casadi_copy(h, H_.nnz(), get_ptr(m->h_prev));
+      casadi_copy(a, A_.nnz(), get_ptr(m->a_prev));
+    }
+    m->called_before = true;
+    return same;
+  }
+
   void Conic::generateNativeCode(std::ostream& file) const {
     casadi_error("generateNativeCode not defined for class " + class_name());
   }
@@ -703,10 +734,11 @@ namespace casadi {
   void Conic::serialize_body(SerializingStream &s) const {
     FunctionInternal::serialize_body(s);
 
-    s.version("Conic", 1);
+    s.version("Conic", 2);
     s.pack("Conic::discrete", discrete_);
     s.pack("Conic::print_problem", print_problem_);
     s.pack("Conic::error_on_fail", error_on_fail_);
+    s.pack("Conic::reuse_factorization", reuse_factorization_);
     s.pack("Conic::H", H_);
     s.pack("Conic::A", A_);
     s.pack("Conic::Q", Q_);
@@ -726,10 +758,11 @@ namespace casadi {
   }
 
   Conic::Conic(DeserializingStream & s) : FunctionInternal(s) {
-    s.version("Conic", 1);
+    s.version("Conic", 2);
     s.unpack("Conic::discrete", discrete_);
     s.unpack("Conic::print_problem", print_problem_);
     s.unpack("Conic::error_on_fail", error_on_fail_);
+    s.unpack("Conic::reuse_factorization", reuse_factorization_);
     s.unpack("Conic::H", H_);
     s.unpack("Conic::A", A_);
     s.unpack("Conic::Q", Q_);
@@ -74,6 +74,15 @@ namespace casadi {
       This can be proven with soc(x, y)=[y*I   x; x'  y]
       using the Shur complement.
 
+      Warm starting: x0, lam_x0 and lam_a0 give an initial guess for the
+      primal-dual solution. For active-set solvers, the nonzero entries of
+      lam_x0 and lam_a0 also give the initial working set, a positive entry
+      for an active upper bound and a negative entry for an active lower bound.
+
+      Hot starting: with the option 'reuse_factorization', a solver may reuse its
+      state from the previous call with the same memory object, e.g. a
+      matrix factorization, if H and A are unchanged.
+
 
       \generalsection{Conic}
       \pluginssection{Conic}
@@ -162,11 +171,11 @@ enum ConicInput {
   CONIC_LBX,
   /// dense, (n x 1)
   CONIC_UBX,
-  /// dense, (n x 1)
+  /// Initial guess for the primal solution: dense, (n x 1)
   CONIC_X0,
-  /// dense
+  /// Initial guess for the dual solution corresponding to simple bounds: dense, (n x 1)
   CONIC_LAM_X0,
-  /// dense
+  /// Initial guess for the dual solution corresponding to linear bounds: dense, (nc x 1)
   CONIC_LAM_A0,
   /// The matrix Q: sparse symmetric, (np^2 x n)
   CONIC_Q,
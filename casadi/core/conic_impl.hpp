@@ -43,6 +43,12 @@ namespace casadi {
 
     // Number of iterations performed
     casadi_int iter_count;
+
+    // Nonzeros of H and A in the previous call, if hot starting
+    std::vector<double> h_prev, a_prev;
+
+    // Has there been a previous call?
+    bool called_before;
   };
 
   /// Internal class
@@ -133,10 +139,18 @@ namespace casadi {
 
     /// Get all statistics
     Dict get_stats(void* mem) const override;
+
+    /** \brief Can the state of the previous call be reused?
+
+        True if hot starting and the nonzeros of H and A are the same as in
+        the previous call with the same memory object. Records H and A.
+    */
+    bool reuse_factorization(ConicMemory* m, const double* h, const double* a) const;
   protected:
     /// Options
     std::vector<bool> discrete_;
     bool print_problem_;
+    bool reuse_factorization_;
 
     /// Problem structure
     Sparsity H_, A_, Q_, P_;
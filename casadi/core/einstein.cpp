@@ -29,12 +29,61 @@
 #include "einstein.hpp"
 #include "casadi_misc.hpp"
 #include "function_internal.hpp"
+#include "thread_pool.hpp"
 #include "runtime/shared.hpp"
 
 using namespace std;
 
 namespace casadi {
 
+  template<>
+  void einstein_eval(casadi_int n_iter,
+      const std::vector<casadi_int>& iter_dims,
+      const std::vector<casadi_int>& strides_a, const std::vector<casadi_int>& strides_b,
+      const std::vector<casadi_int>& strides_c,
+      const double* a_in, const double* b_in, double* c_in) {
+    if (!n_iter) return;
+    casadi_int n = iter_dims.size();
+    const casadi_int* dims = get_ptr(iter_dims);
+    const casadi_int* sa = get_ptr(strides_a)+1;
+    const casadi_int* sb = get_ptr(strides_b)+1;
+    const casadi_int* sc = get_ptr(strides_c)+1;
+    const double* a = a_in+strides_a[0];
+    const double* b = b_in+strides_b[0];
+    double* c = c_in+strides_c[0];
+
+    // Matrix product in the innermost loops
+    casadi_int gemm[4];
+    casadi_int n_gemm = einstein_gemm(iter_dims, strides_a, strides_b, strides_c, gemm);
+
+    // Use threads if there are at least 2^15 multiplications per thread
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = std::min(pool.size(), n_iter >> 15);
+    if (nw>1 && n_gemm<n && sc[0]!=0) {
+      // Split the outermost loop, which writes to distinct entries of C
+      casadi_int n0 = dims[0];
+      nw = std::min(nw, n0);
+      pool.run(nw, nw, [&](casadi_int t, casadi_int w) {
+        for (casadi_int i=t*n0/nw; i<(t+1)*n0/nw; ++i) {
+          einstein_loop<double>(1, n, dims, sa, sb, sc, n_gemm, gemm,
+            a+i*sa[0], b+i*sb[0], c+i*sc[0]);
+        }
+      });
+    } else if (nw>1 && n_gemm==n && gemm[2]>1) {
+      // Split the columns of the matrix product
+      const double* x = gemm[3] ? b : a;
+      const double* y = gemm[3] ? a : b;
+      casadi_int m = gemm[0], k = gemm[1], ncol = gemm[2];
+      nw = std::min(nw, ncol);
+      pool.run(nw, nw, [&](casadi_int t, casadi_int w) {
+        casadi_int j0 = t*ncol/nw, j1 = (t+1)*ncol/nw;
+        casadi_mtimes_dense(x, m, k, y+j0*k, j1-j0, c+j0*m);
+      });
+    } else {
+      einstein_loop<double>(0, n, dims, sa, sb, sc, n_gemm, gemm, a, b, c);
+    }
+  }
+
   Einstein::Einstein(const MX& C, const MX& A, const MX& B,
     const std::vector<casadi_int>& dim_c, const std::vector<casadi_int>& dim_a,
     const std::vector<casadi_int>& dim_b,
@@ -137,36 +186,38 @@ namespace casadi {
       g << g.copy(g.work(arg[0], nnz()), nnz(), g.work(res[0], nnz()));
     }
 
-    // main loop
-    g.local("i", "casadi_int");
-    g << "for (i=0; i<" << n_iter_ << "; ++i) {\n";
+    // Loops in the planned order, innermost loops forming a matrix product
+    // are replaced by a call to the dense kernel
+    casadi_int gemm[4];
+    casadi_int n_gemm = einstein_gemm(iter_dims_, strides_a_, strides_b_, strides_c_, gemm);
+    casadi_int n_loop = iter_dims_.size() - n_gemm;
+    std::string off_a, off_b, off_c;
+    for (casadi_int j=0; j<n_loop; ++j) {
+      std::string ind = "i" + str(j);
+      g.local(ind, "casadi_int");
+      g << "for (" << ind << "=0; " << ind << "<" << iter_dims_[j] << "; ++" << ind << ") {\n";
+      if (strides_a_[1+j]) off_a += "+" + ind + "*" + str(strides_a_[1+j]);
+      if (strides_b_[1+j]) off_b += "+" + ind + "*" + str(strides_b_[1+j]);
+      if (strides_c_[1+j]) off_c += "+" + ind + "*" + str(strides_c_[1+j]);
+    }
 
     // Data pointers
     g.local("cr", "const casadi_real", "*");
     g.local("cs", "const casadi_real", "*");
     g.local("rr", "casadi_real", "*");
-    g << "cr = " << g.work(arg[1], dep(1).nnz()) << "+" << strides_a_[0] << ";\n";
-    g << "cs = " << g.work(arg[2], dep(2).nnz()) << "+" << strides_b_[0] << ";\n";
-    g << "rr = " << g.work(res[0], dep(0).nnz()) << "+" << strides_c_[0] << ";\n";
-
-    // Construct indices
-    for (casadi_int j=0; j<iter_dims_.size(); ++j) {
-      if (j==0) {
-        g.local("k", "casadi_int");
-        g << "k = i;\n";
-        g.local("j", "casadi_int");
-      }
-      g << "j = k % " << iter_dims_[j] << ";\n";
-      if (j+1<iter_dims_.size()) g << "k /= " << iter_dims_[j] << ";\n";
-      if (strides_a_[1+j]) g << "cr += j*" << strides_a_[1+j] << ";\n";
-      if (strides_b_[1+j]) g << "cs += j*" << strides_b_[1+j] << ";\n";
-      if (strides_c_[1+j]) g << "rr += j*" << strides_c_[1+j] << ";\n";
-    }
+    g << "cr = " << g.work(arg[1], dep(1).nnz()) << "+" << strides_a_[0] << off_a << ";\n";
+    g << "cs = " << g.work(arg[2], dep(2).nnz()) << "+" << strides_b_[0] << off_b << ";\n";
+    g << "rr = " << g.work(res[0], dep(0).nnz()) << "+" << strides_c_[0] << off_c << ";\n";
 
     // Perform the actual multiplication
-    g << "*rr += *cr**cs;\n";
+    if (n_gemm>0) {
+      g << g.mtimes(gemm[3] ? "cs" : "cr", gemm[0], gemm[1], gemm[3] ? "cr" : "cs", gemm[2], "rr")
+        << "\n";
+    } else {
+      g << "*rr += *cr**cs;\n";
+    }
 
-    g << "}\n";
+    for (casadi_int j=0; j<n_loop; ++j) g << "}\n";
   }
 
 } // namespace casadi
@@ -1124,6 +1124,9 @@ namespace casadi {
   }
 
   std::string Function::serialize(const Dict& opts) const {
+    auto it = opts.find("binary");
+    casadi_assert(it==opts.end() || !it->second.to_bool(),
+      "Option 'binary' is not supported for serialization to a string. Use 'save' instead.");
     std::stringstream ss;
     serialize(ss, opts);
     return ss.str();
@@ -738,6 +738,12 @@ namespace casadi {
 
     /** \brief Serialize */
     std::string serialize(const Dict& opts=Dict()) const;
+
+    /** \brief Save to a file
+     *
+     * With option "binary", arrays are written as raw bytes rather than
+     * text, which is faster to load.
+     */
     void save(const std::string &fname, const Dict& opts=Dict()) const;
 
     std::string export_code(const std::string& lang, const Dict& options=Dict()) const;
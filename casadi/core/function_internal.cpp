@@ -41,9 +41,13 @@
 #include "conic_impl.hpp"
 #include "integrator_impl.hpp"
 #include "external_impl.hpp"
+#include "importer_internal.hpp"
+#include "sparsity_internal.hpp"
+#include "thread_pool.hpp"
 
 #include <cctype>
 #include <typeinfo>
+#include <atomic>
 #ifdef WITH_DL
 #include <cstdlib>
 #include <ctime>
@@ -74,6 +78,7 @@ namespace casadi {
     ad_weight_ = 0.33; // i.e. nf <= 2*na <=> 1/3*nf <= (1-1/3)*na, forward when tie
     // Both modes equally expensive by default (no "taping" needed)
     ad_weight_sp_ = 0.49; // Forward when tie
+    parallel_coloring_ = false;
     always_inline_ = false;
     never_inline_ = false;
     jac_penalty_ = 2;
@@ -113,8 +118,8 @@ namespace casadi {
   }
 
   ProtoFunction::~ProtoFunction() {
-    for (void* m : mem_) {
-      if (m!=nullptr) casadi_warning("Memory object has not been properly freed");
+    for (int i=0; i<mem_.size(); ++i) {
+      if (mem_.at(i)!=nullptr) casadi_warning("Memory object has not been properly freed");
     }
     mem_.clear();
   }
@@ -185,6 +190,11 @@ namespace casadi {
         "Overrides default behavior. Set to 0 and 1 to force forward and "
         "reverse mode respectively. Cf. option \"ad_weight\". "
         "When set to -1, sparsity is completely ignored and dense matrices are used."}},
+      {"parallel_coloring",
+       {OT_BOOL,
+        "Use multithreaded speculative graph coloring when computing Jacobian "
+        "and Hessian seed matrices. The number of threads is set with "
+        "GlobalOptions::setNumThreads. [default: false]"}},
       {"always_inline",
        {OT_BOOL,
         "Force inlining."}},
@@ -351,6 +361,7 @@ namespace casadi {
     opts["derivative_of"] = derivative_of_;
     opts["ad_weight"] = ad_weight_;
     opts["ad_weight_sp"] = ad_weight_sp_;
+    opts["parallel_coloring"] = parallel_coloring_;
     opts["always_inline"] = always_inline_;
     opts["never_inline"] = never_inline_;
     opts["max_num_dir"] = max_num_dir_;
@@ -415,6 +426,8 @@ namespace casadi {
         ad_weight_ = op.second;
       } else if (op.first=="ad_weight_sp") {
         ad_weight_sp_ = op.second;
+      } else if (op.first=="parallel_coloring") {
+        parallel_coloring_ = op.second;
       } else if (op.first=="max_num_dir") {
         max_num_dir_ = op.second;
       } else if (op.first=="enable_forward") {
@@ -556,20 +569,30 @@ namespace casadi {
         jit_name_ = std::string(jit_name_.begin(), jit_name_.begin()+jit_name_.size()-2);
       }
       if (has_codegen()) {
-        if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
-        // JIT everything
-        Dict opts;
-        // Override the default to avoid random strings in the generated code
-        opts["prefix"] = "jit";
-        CodeGenerator gen(jit_name_, opts);
-        gen.add(self());
-        if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
-        compiler_ = Importer(gen.generate(), compiler_plugin_, jit_options_);
-        if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
-        // Try to load
-        eval_ = (eval_t) compiler_.get_function(name_);
-        checkout_ = (casadi_checkout_t) compiler_.get_function(name_ + "checkout");
-        release_ = (casadi_release_t) compiler_.get_function(name_ + "release");
+        // Compile directly from the instructions, if supported by the plugin
+        if (ImporterInternal::has_jit_function(compiler_plugin_)) {
+          if (verbose_) casadi_message("Compiling function '" + name_ + "' directly..");
+          compiler_ = Importer(jit_name_, compiler_plugin_, jit_options_);
+          eval_ = (eval_t) compiler_->jit_function(self());
+          if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
+        }
+        // Otherwise, codegenerate and compile the generated source
+        if (eval_==nullptr) {
+          if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
+          // JIT everything
+          Dict opts;
+          // Override the default to avoid random strings in the generated code
+          opts["prefix"] = "jit";
+          CodeGenerator gen(jit_name_, opts);
+          gen.add(self());
+          if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
+          compiler_ = Importer(gen.generate(), compiler_plugin_, jit_options_);
+          if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
+          // Try to load
+          eval_ = (eval_t) compiler_.get_function(name_);
+          checkout_ = (casadi_checkout_t) compiler_.get_function(name_ + "checkout");
+          release_ = (casadi_release_t) compiler_.get_function(name_ + "release");
+        }
         casadi_assert(eval_!=nullptr, "Cannot load JIT'ed function.");
       } else {
         // Just jit dependencies
@@ -825,8 +848,9 @@ namespace casadi {
       // Serial maps are cached
       string fname = "map" + str(n) + "_" + name_;
       if (!incache(fname, f)) {
-        // Create new serial map
-        f = Map::create(parallelization, self(), n);
+        // Create new serial map, batched if the function supports it
+        f = get_map(fname, n);
+        if (f.is_null()) f = Map::create(parallelization, self(), n);
         casadi_assert_dev(f.name()==fname);
         // Save in cache
         tocache(f);
@@ -948,41 +972,65 @@ namespace casadi {
     casadi_int nz_in = nnz_in(iind);
     casadi_int nz_out = nnz_out(oind);
 
-    // Evaluation buffers
-    vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
-    vector<bvec_t*> res(sz_res(), nullptr);
-    vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w(), 0);
-
-    // Seeds and sensitivities
-    vector<bvec_t> seed(nz_in, 0);
-    arg[iind] = get_ptr(seed);
-    vector<bvec_t> sens(nz_out, 0);
-    res[oind] = get_ptr(sens);
-    if (!fwd) std::swap(seed, sens);
+    // Number of seed and sensitivity directions
+    casadi_int n_seed = fwd ? nz_in : nz_out;
+    casadi_int n_sens = fwd ? nz_out : nz_in;
 
     // Number of forward sweeps we must make
-    casadi_int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    casadi_int nsweep = n_seed / bvec_size;
+    if (n_seed % bvec_size) nsweep++;
 
     // Print
     if (verbose_) {
       casadi_message(str(nsweep) + string(fwd ? " forward" : " reverse") + " sweeps "
-                     "needed for " + str(seed.size()) + " directions");
+                     "needed for " + str(n_seed) + " directions");
     }
 
+    // Sweeps are independent and can be executed in parallel, if supported
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = sp_thread_safe() ? std::min(pool.size(), nsweep) : 1;
+
+    // Evaluation buffers for each worker
+    struct Buffers {
+      vector<typename JacSparsityTraits<fwd>::arg_t> arg;
+      vector<bvec_t*> res;
+      vector<casadi_int> iw;
+      vector<bvec_t> w, seed, sens;
+    };
+    vector<Buffers> buf(nw);
+
+    // Dependencies found in each sweep
+    vector<std::vector<casadi_int> > jcol_s(nsweep), jrow_s(nsweep);
+
     // Progress
     casadi_int progress = -10;
-
-    // Temporary vectors
-    std::vector<casadi_int> jcol, jrow;
+    std::atomic<casadi_int> n_done(0);
 
     // Loop over the variables, bvec_size variables at a time
-    for (casadi_int s=0; s<nsweep; ++s) {
+    pool.run(nsweep, nw, [&](casadi_int s, casadi_int wk) {
+      // Allocate buffers for the worker
+      Buffers& b = buf[wk];
+      if (b.arg.empty()) {
+        b.arg.resize(sz_arg(), nullptr);
+        b.res.resize(sz_res(), nullptr);
+        b.iw.resize(sz_iw());
+        b.w.resize(sz_w(), 0);
+        b.seed.resize(n_seed, 0);
+        b.sens.resize(n_sens, 0);
+        if (fwd) {
+          b.arg[iind] = get_ptr(b.seed);
+          b.res[oind] = get_ptr(b.sens);
+        } else {
+          b.arg[iind] = get_ptr(b.sens);
+          b.res[oind] = get_ptr(b.seed);
+        }
+      }
+      vector<bvec_t>& seed = b.seed;
+      vector<bvec_t>& sens = b.sens;
 
-      // Print progress
-      if (verbose_) {
-        casadi_int progress_new = (s*100)/nsweep;
+      // Print progress (from the calling thread only)
+      if (verbose_ && wk==0) {
+        casadi_int progress_new = (n_done*100)/nsweep;
         // Print when entering a new decade
         if (progress_new / 10 > progress / 10) {
           progress = progress_new;
@@ -1002,8 +1050,8 @@ namespace casadi {
       }
 
       // Propagate the dependencies
-      JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
-                                  get_ptr(iw), get_ptr(w), memory(0));
+      JacSparsityTraits<fwd>::sp(this, get_ptr(b.arg), get_ptr(b.res),
+                                  get_ptr(b.iw), get_ptr(b.w), memory(0));
 
       // Loop over the nonzeros of the output
       for (casadi_int el=0; el<sens.size(); ++el) {
@@ -1025,8 +1073,8 @@ namespace casadi {
             // If dependents on the variable
             if ((bvec_t(1) << i) & spsens) {
               // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              jcol_s[s].push_back(el);
+              jrow_s[s].push_back(i+offset);
             }
           }
         }
@@ -1036,6 +1084,14 @@ namespace casadi {
       for (casadi_int i=0; i<ndir_local; ++i) {
         seed[offset+i] = 0;
       }
+      n_done++;
+    });
+
+    // Collect the dependencies, in the order of the sweeps
+    std::vector<casadi_int> jcol, jrow;
+    for (casadi_int s=0; s<nsweep; ++s) {
+      jcol.insert(jcol.end(), jcol_s[s].begin(), jcol_s[s].end());
+      jrow.insert(jrow.end(), jrow_s[s].begin(), jrow_s[s].end());
     }
 
     // Construct sparsity pattern and return
@@ -1291,18 +1347,31 @@ namespace casadi {
     // Number of nonzero outputs
     casadi_int nz_out = nnz_out(oind);
 
-    // Seeds and sensitivities
-    vector<bvec_t> s_in(nz_in, 0);
-    vector<bvec_t> s_out(nz_out, 0);
-
-    // Evaluation buffers
-    vector<const bvec_t*> arg_fwd(sz_arg(), nullptr);
-    vector<bvec_t*> arg_adj(sz_arg(), nullptr);
-    arg_fwd[iind] = arg_adj[iind] = get_ptr(s_in);
-    vector<bvec_t*> res(sz_res(), nullptr);
-    res[oind] = get_ptr(s_out);
-    vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w());
+    // Sweeps within a level are independent and can be executed in parallel, if supported
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = sp_thread_safe() ? pool.size() : 1;
+
+    // Seeds, sensitivities and evaluation buffers for each worker
+    struct Buffers {
+      vector<bvec_t> s_in, s_out;
+      vector<const bvec_t*> arg_fwd;
+      vector<bvec_t*> arg_adj, res;
+      vector<casadi_int> iw;
+      vector<bvec_t> w;
+    };
+    vector<Buffers> buf(nw);
+
+    // A sweep: seeds to be toggled, lookup table and resulting dependencies
+    struct Sweep {
+      std::vector<casadi_int> toggle;
+      std::vector<casadi_int> lookup_col, lookup_row, lookup_value;
+      std::vector<casadi_int> jcol, jrow;
+    };
+    std::vector<Sweep> sweeps;
+    Sweep sweep;
+
+    // Number of sweeps to collect before processing them
+    casadi_int max_sweeps = 16*nw;
 
     // Sparsity triplet accumulator
     std::vector<casadi_int> jcol, jrow;
@@ -1381,17 +1450,10 @@ namespace casadi {
             "(fwd cost: " + str(fwd_cost) + ", adj cost: " + str(adj_cost) + ")");
       }
 
-      // Get seeds and sensitivities
-      bvec_t* seed_v = use_fwd ? get_ptr(s_in) : get_ptr(s_out);
-      bvec_t* sens_v = use_fwd ? get_ptr(s_out) : get_ptr(s_in);
-
       // The number of zeros in the seed and sensitivity directions
       casadi_int nz_seed = use_fwd ? nz_in  : nz_out;
       casadi_int nz_sens = use_fwd ? nz_out : nz_in;
 
-      // Clear the seeds
-      for (casadi_int i=0; i<nz_seed; ++i) seed_v[i]=0;
-
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
 
@@ -1431,11 +1493,89 @@ namespace casadi {
       std::vector<casadi_int> fine_col_lookup = lookupvector(fine_col, nz_sens+1);
       std::vector<casadi_int> fine_row_lookup = lookupvector(fine_row, nz_seed+1);
 
-      // Triplet data used as a lookup table
-      std::vector<casadi_int> lookup_col;
-      std::vector<casadi_int> lookup_row;
-      std::vector<casadi_int> lookup_value;
+      // Process the collected sweeps
+      auto process_sweeps = [&]() {
+        pool.run(sweeps.size(), nw, [&](casadi_int k, casadi_int wk) {
+          // Allocate buffers for the worker
+          Buffers& b = buf[wk];
+          if (b.arg_fwd.empty()) {
+            b.s_in.resize(nz_in, 0);
+            b.s_out.resize(nz_out, 0);
+            b.arg_fwd.resize(sz_arg(), nullptr);
+            b.arg_adj.resize(sz_arg(), nullptr);
+            b.arg_fwd[iind] = b.arg_adj[iind] = get_ptr(b.s_in);
+            b.res.resize(sz_res(), nullptr);
+            b.res[oind] = get_ptr(b.s_out);
+            b.iw.resize(sz_iw());
+            b.w.resize(sz_w());
+          }
+          Sweep& sw = sweeps[k];
+
+          // Get seeds and sensitivities
+          bvec_t* seed_v = use_fwd ? get_ptr(b.s_in) : get_ptr(b.s_out);
+          bvec_t* sens_v = use_fwd ? get_ptr(b.s_out) : get_ptr(b.s_in);
+
+          // Toggle on seeds
+          for (casadi_int t=0; t<sw.toggle.size(); t+=3) {
+            bvec_toggle(seed_v, sw.toggle[t], sw.toggle[t+1], sw.toggle[t+2]);
+          }
+
+          // Construct lookup table
+          IM lookup = IM::triplet(sw.lookup_row, sw.lookup_col, sw.lookup_value, bvec_size,
+                                  coarse_col.size());
+
+          // Propagate the dependencies
+          if (use_fwd) {
+            JacSparsityTraits<true>::sp(this, get_ptr(b.arg_fwd), get_ptr(b.res),
+              get_ptr(b.iw), get_ptr(b.w), memory(0));
+          } else {
+            fill(b.w.begin(), b.w.end(), 0);
+            JacSparsityTraits<false>::sp(this, get_ptr(b.arg_adj), get_ptr(b.res),
+              get_ptr(b.iw), get_ptr(b.w), memory(0));
+          }
+
+          // Temporary bit work vector
+          bvec_t spsens;
+
+          // Loop over the cols of coarse blocks
+          for (casadi_int cri=0;cri<coarse_col.size()-1;++cri) {
+
+            // Loop over the cols of fine blocks within the current coarse block
+            for (casadi_int fri=fine_col_lookup[coarse_col[cri]];
+                 fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
+              // Lump individual sensitivities together into fine block
+              bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
+
+              // Next iteration if no sparsity
+              if (!spsens) continue;
+
+              // Loop over all bvec_bits
+              for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                if (spsens & bvec_lookup[bvec_i]) {
+                  // if dependency is found, add it to the new sparsity pattern
+                  casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
+                  if (ind==-1) continue;
+                  sw.jrow.push_back(bvec_i+lookup->at(ind));
+                  sw.jcol.push_back(fri);
+                }
+              }
+            }
+          }
 
+          // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
+          fill(b.s_in.begin(), b.s_in.end(), 0);
+
+          // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
+          fill(b.s_out.begin(), b.s_out.end(), 0);
+        });
+
+        // Collect the dependencies, in the order of the sweeps
+        for (auto&& sw : sweeps) {
+          jrow.insert(jrow.end(), sw.jrow.begin(), sw.jrow.end());
+          jcol.insert(jcol.end(), sw.jcol.begin(), sw.jcol.end());
+        }
+        sweeps.clear();
+      };
 
       // The maximum number of fine blocks contained in one coarse block
       casadi_int n_fine_blocks_max = 0;
@@ -1475,14 +1615,15 @@ namespace casadi {
               // Loop over the coarse block cols that appear in the coloring
               // for the current coarse seed direction
               for (casadi_int cri=rT.colind(cci);cri<rT.colind(cci+1);++cri) {
-                lookup_col.push_back(rT.row(cri));
-                lookup_row.push_back(bvec_i+bvec_i_mod);
-                lookup_value.push_back(value);
+                sweep.lookup_col.push_back(rT.row(cri));
+                sweep.lookup_row.push_back(bvec_i+bvec_i_mod);
+                sweep.lookup_value.push_back(value);
               }
 
               // Toggle on seeds
-              bvec_toggle(seed_v, fine_row[fci+fci_start], fine_row[fci+fci_start+1],
-                          bvec_i+bvec_i_mod);
+              sweep.toggle.push_back(fine_row[fci+fci_start]);
+              sweep.toggle.push_back(fine_row[fci+fci_start+1]);
+              sweep.toggle.push_back(bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
           }
@@ -1497,58 +1638,10 @@ namespace casadi {
             // Statistics
             nsweeps+=1;
 
-            // Construct lookup table
-            IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
-                                    coarse_col.size());
-
-            // Propagate the dependencies
-            if (use_fwd) {
-              JacSparsityTraits<true>::sp(this, get_ptr(arg_fwd), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
-            } else {
-              fill(w.begin(), w.end(), 0);
-              JacSparsityTraits<false>::sp(this, get_ptr(arg_adj), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
-            }
-
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (casadi_int cri=0;cri<coarse_col.size()-1;++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (casadi_int fri=fine_col_lookup[coarse_col[cri]];
-                   fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
-
-                // Next iteration if no sparsity
-                if (!spsens) continue;
-
-                // Loop over all bvec_bits
-                for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    jrow.push_back(bvec_i+lookup->at(ind));
-                    jcol.push_back(fri);
-                  }
-                }
-              }
-            }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            fill(s_in.begin(), s_in.end(), 0);
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            fill(s_out.begin(), s_out.end(), 0);
-
-            // Clean lookup table
-            lookup_col.clear();
-            lookup_row.clear();
-            lookup_value.clear();
+            // Queue the sweep
+            sweeps.push_back(std::move(sweep));
+            sweep = Sweep();
+            if (sweeps.size()>=max_sweeps) process_sweeps();
           }
 
           if (n_fine_blocks_max>fci_cap) {
@@ -1563,6 +1656,9 @@ namespace casadi {
 
       }
 
+      // Process the remaining sweeps
+      process_sweeps();
+
       // Swap results if adjoint mode was used
       if (use_fwd) {
         // Construct fine sparsity pattern
@@ -1730,7 +1826,10 @@ namespace casadi {
 
       // Star coloring if symmetric
       if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
-      D1 = A.star_coloring();
+      coloring_stats_.tic();
+      D1 = parallel_coloring_ ? A->star_coloring_parallel(1, numeric_limits<casadi_int>::max())
+                              : A.star_coloring();
+      coloring_stats_.toc();
       if (verbose_) {
         casadi_message("Star coloring completed: " + str(D1.size2())
           + " directional derivatives needed ("
@@ -1770,7 +1869,10 @@ namespace casadi {
           bool d = best_coloring>=w*static_cast<double>(A.size1());
           casadi_int max_colorings_to_test =
             d ? A.size1() : static_cast<casadi_int>(floor(best_coloring/w));
-          D1 = AT.uni_coloring(A, max_colorings_to_test);
+          coloring_stats_.tic();
+          D1 = parallel_coloring_ ? AT->uni_coloring_parallel(A, max_colorings_to_test)
+                                  : AT.uni_coloring(A, max_colorings_to_test);
+          coloring_stats_.toc();
           if (D1.is_null()) {
             if (verbose_) {
               casadi_message("Forward mode coloring interrupted (more than "
@@ -1791,7 +1893,10 @@ namespace casadi {
           casadi_int max_colorings_to_test =
             d ? A.size2() : static_cast<casadi_int>(floor(best_coloring/(1-w)));
 
-          D2 = A.uni_coloring(AT, max_colorings_to_test);
+          coloring_stats_.tic();
+          D2 = parallel_coloring_ ? A->uni_coloring_parallel(AT, max_colorings_to_test)
+                                  : A.uni_coloring(AT, max_colorings_to_test);
+          coloring_stats_.toc();
           if (D2.is_null()) {
             if (verbose_) {
               casadi_message("Adjoint mode coloring interrupted (more than "
@@ -2246,6 +2351,9 @@ namespace casadi {
       << "return 0;\n"
       << "}\n\n";
 
+    // Batched entry point
+    if (g.with_batch) codegen_batch(g);
+
     // Generate mex gateway for the function
     if (g.mex) {
       // Begin conditional compilation
@@ -2400,6 +2508,67 @@ namespace casadi {
     g.flush(g.body);
   }
 
+  void FunctionInternal::codegen_batch(CodeGenerator& g) const {
+    // Nonzeros of one point are stored at the beginning of the work vector
+    casadi_int sz_io = nnz_in() + nnz_out();
+
+    g << g.declare("int " + name_ + "_batch(const casadi_real** arg, casadi_real** res, "
+                   "casadi_int* iw, casadi_real* w, int mem, casadi_int n)") << " {\n"
+      << "casadi_int j, k;\n"
+      << "const casadi_real** arg1 = arg+" << n_in_ << ";\n"
+      << "casadi_real** res1 = res+" << n_out_ << ";\n";
+
+    // Input and output buffers for one point
+    casadi_int offset = 0;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      g << "arg1[" << i << "] = arg[" << i << "] ? w+" << offset << " : 0;\n";
+      offset += nnz_in(i);
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      g << "res1[" << i << "] = res[" << i << "] ? w+" << offset << " : 0;\n";
+      offset += nnz_out(i);
+    }
+
+    // Evaluate one point at a time
+    g << "for (j=0; j<n; ++j) {\n";
+    offset = 0;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      if (nnz_in(i)>0) {
+        g << "if (arg[" << i << "]) for (k=0; k<" << nnz_in(i) << "; ++k) "
+          << "w[" << offset << "+k] = arg[" << i << "][k*n+j];\n";
+      }
+      offset += nnz_in(i);
+    }
+    g << "if (" << codegen_name(g) << "(arg1, res1, iw, w+" << sz_io << ", mem)) return 1;\n";
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (nnz_out(i)>0) {
+        g << "if (res[" << i << "]) for (k=0; k<" << nnz_out(i) << "; ++k) "
+          << "res[" << i << "][k*n+j] = w[" << offset << "+k];\n";
+      }
+      offset += nnz_out(i);
+    }
+    g << "}\n"
+      << "return 0;\n"
+      << "}\n\n";
+
+    // Work vector lengths
+    codegen_batch_work(g, n_in_ + sz_arg(), n_out_ + sz_res(), sz_iw(), sz_io + sz_w());
+  }
+
+  void FunctionInternal::codegen_batch_work(CodeGenerator& g, casadi_int sz_arg,
+      casadi_int sz_res, casadi_int sz_iw, casadi_int sz_w) const {
+    g << g.declare(
+        "int " + name_ + "_batch_work(casadi_int *sz_arg, casadi_int* sz_res, "
+        "casadi_int *sz_iw, casadi_int *sz_w)")
+      << " {\n"
+      << "if (sz_arg) *sz_arg = " << sz_arg << ";\n"
+      << "if (sz_res) *sz_res = " << sz_res << ";\n"
+      << "if (sz_iw) *sz_iw = " << sz_iw << ";\n"
+      << "if (sz_w) *sz_w = " << sz_w << ";\n"
+      << "return 0;\n"
+      << "}\n\n";
+  }
+
   std::string FunctionInternal::codegen_name(const CodeGenerator& g, bool ns) const {
     if (ns) {
       // Get the index of the function
@@ -2563,6 +2732,17 @@ namespace casadi {
     return stats;
   }
 
+  Dict FunctionInternal::get_stats(void* mem) const {
+    Dict stats = ProtoFunction::get_stats(mem);
+    // Time spent in graph coloring for derivative seeds
+    if (coloring_stats_.n_call>0) {
+      stats["n_call_coloring"] = coloring_stats_.n_call;
+      stats["t_wall_coloring"] = coloring_stats_.t_wall;
+      stats["t_proc_coloring"] = coloring_stats_.t_proc;
+    }
+    return stats;
+  }
+
   bool FunctionInternal::has_derivative() const {
     return enable_forward_ || enable_reverse_ || enable_jacobian_ || enable_fd_;
   }
@@ -3121,8 +3301,9 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
-    for (auto&& i : mem_) {
-      if (i!=nullptr) free_mem(i);
+    for (int i=0; i<mem_.size(); ++i) {
+      void* m = mem_.at(i);
+      if (m!=nullptr) free_mem(m);
     }
     mem_.clear();
   }
@@ -3200,37 +3381,29 @@ namespace casadi {
   }
 
   void* ProtoFunction::memory(int ind) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
     return mem_.at(ind);
   }
 
   int ProtoFunction::checkout() const {
+    // Use an unused memory object, if any
+    int ind = mem_.pop();
+    if (ind>=0) return ind;
+    // Allocate a new memory object
+    void* m = alloc_mem();
+    {
 #ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
+      std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
-    if (unused_.empty()) {
-      // Allocate a new memory object
-      void* m = alloc_mem();
-      mem_.push_back(m);
-      if (init_mem(m)) {
-        casadi_error("Failed to create or initialize memory object");
-      }
-      return mem_.size()-1;
-    } else {
-      // Use an unused memory object
-      casadi_int m = unused_.top();
-      unused_.pop();
-      return m;
+      ind = mem_.add(m);
+    }
+    if (init_mem(m)) {
+      casadi_error("Failed to create or initialize memory object");
     }
+    return ind;
   }
 
   void ProtoFunction::release(int mem) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    unused_.push(mem);
+    mem_.push(mem);
   }
 
   Function FunctionInternal::
@@ -3519,7 +3692,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 1);
+    s.version("FunctionInternal", 2);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -3550,6 +3723,7 @@ namespace casadi {
 
     s.pack("FunctionInternal::ad_weight", ad_weight_);
     s.pack("FunctionInternal::ad_weight_sp", ad_weight_sp_);
+    s.pack("FunctionInternal::parallel_coloring", parallel_coloring_);
     s.pack("FunctionInternal::always_inline", always_inline_);
     s.pack("FunctionInternal::never_inline", never_inline_);
 
@@ -3583,7 +3757,7 @@ namespace casadi {
   }
 
   FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
-    s.version("FunctionInternal", 1);
+    s.version("FunctionInternal", 2);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -3614,6 +3788,7 @@ namespace casadi {
 
     s.unpack("FunctionInternal::ad_weight", ad_weight_);
     s.unpack("FunctionInternal::ad_weight_sp", ad_weight_sp_);
+    s.unpack("FunctionInternal::parallel_coloring", parallel_coloring_);
     s.unpack("FunctionInternal::always_inline", always_inline_);
     s.unpack("FunctionInternal::never_inline", never_inline_);
 
@@ -35,6 +35,7 @@
 #include "options.hpp"
 #include "shared_object_internal.hpp"
 #include "timing.hpp"
+#include "memory_pool.hpp"
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
 #include <mingw.mutex.h>
@@ -190,11 +191,8 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
 
   private:
-    /// Memory objects
-    mutable std::vector<void*> mem_;
-
-    /// Unused memory objects
-    mutable std::stack<casadi_int> unused_;
+    /// Memory objects, checkout and release are lock-free
+    mutable MemoryPool mem_;
   };
 
   /** \brief Internal class for Function
@@ -263,6 +261,9 @@ namespace casadi {
     virtual bool has_sprev() const { return false;}
     ///@}
 
+    /** \brief  Can seeds be propagated concurrently, given separate work vectors? */
+    virtual bool sp_thread_safe() const { return false;}
+
     ///@{
     /** \brief  Evaluate numerically */
     int eval_gen(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const;
@@ -496,6 +497,9 @@ namespace casadi {
     /** \brief Get oracle */
     virtual const Function& oracle() const;
 
+    /// Get all statistics, including time spent in graph coloring
+    Dict get_stats(void* mem) const override;
+
     /** \brief Can derivatives be calculated in any way? */
     bool has_derivative() const;
 
@@ -582,6 +586,18 @@ namespace casadi {
     /** \brief Codegen sparsities */
     void codegen_sparsities(CodeGenerator& g) const;
 
+    /** \brief Generate the batched entry point <name>_batch and <name>_batch_work
+     *
+     * Evaluates n points, with nonzero k of point j of each input and output stored
+     * at position k*n + j (structure-of-arrays). The default implementation
+     * evaluates the points one at a time.
+     */
+    virtual void codegen_batch(CodeGenerator& g) const;
+
+    /** \brief Generate <name>_batch_work, returning the work vector lengths of <name>_batch */
+    void codegen_batch_work(CodeGenerator& g, casadi_int sz_arg, casadi_int sz_res,
+                            casadi_int sz_iw, casadi_int sz_w) const;
+
     /** \brief Get name in codegen */
     virtual std::string codegen_name(const CodeGenerator& g, bool ns=true) const;
 
@@ -849,6 +865,12 @@ namespace casadi {
     /** \brief Generate/retrieve cached serial map */
     Function map(casadi_int n, const std::string& parallelization) const;
 
+    /** \brief Serial map evaluating all instances in one batched operation
+     *
+     * Returns a null Function if not available, in which case a Map is created
+     */
+    virtual Function get_map(const std::string& name, casadi_int n) const { return Function();}
+
     /** \brief Export an input file that can be passed to generate C code with a main */
     void generate_in(const std::string& fname, const double** arg) const;
     void generate_out(const std::string& fname, double** res) const;
@@ -926,6 +948,12 @@ namespace casadi {
     /// Weighting factor for derivative calculation and sparsity pattern calculation
     double ad_weight_, ad_weight_sp_;
 
+    /// Use multithreaded graph coloring
+    bool parallel_coloring_;
+
+    /// Accumulated time spent in graph coloring
+    mutable FStats coloring_stats_;
+
     /// Maximum number of sensitivity directions
     casadi_int max_num_dir_;
 
@@ -25,6 +25,7 @@
 
 #include "global_options.hpp"
 #include "exception.hpp"
+#include "sx_node.hpp"
 
 namespace casadi {
 
@@ -36,7 +37,24 @@ namespace casadi {
 
   casadi_int GlobalOptions::max_num_dir = 64;
 
+  // By default, one thread per hardware thread
+  casadi_int GlobalOptions::num_threads = 0;
+
   // By default, use zero-based indexing
   casadi_int GlobalOptions::start_index = 0;
 
+  bool GlobalOptions::hash_consing = false;
+
+  casadi_int GlobalOptions::getHashConsingLookups() {
+    return SXNode::hash_cons_lookups_;
+  }
+
+  casadi_int GlobalOptions::getHashConsingHits() {
+    return SXNode::hash_cons_hits_;
+  }
+
+  void GlobalOptions::resetHashConsingStats() {
+    SXNode::hash_cons_lookups_ = SXNode::hash_cons_hits_ = 0;
+  }
+
 } // namespace casadi
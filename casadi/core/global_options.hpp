@@ -68,6 +68,19 @@ namespace casadi {
 
       static casadi_int start_index;
 
+      /** \brief Number of threads in the shared pool used for parallel evaluation
+      * Includes the calling thread. Zero means the number of hardware threads.
+      * Default: 0
+      */
+      static casadi_int num_threads;
+
+      /** \brief Share identical SX operations at construction time (hash-consing)
+      * An operation on the same arguments as an existing expression returns that
+      * expression instead of a new node. Commutative operations match in either order.
+      * Default: false
+      */
+      static bool hash_consing;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -86,6 +99,22 @@ namespace casadi {
       static void setMaxNumDir(casadi_int ndir) { max_num_dir=ndir; }
       static casadi_int getMaxNumDir() { return max_num_dir; }
 
+      static void setNumThreads(casadi_int n) { num_threads=n; }
+      static casadi_int getNumThreads() { return num_threads; }
+
+      // Setter and getter for hash_consing
+      static void setHashConsing(bool flag) { hash_consing = flag; }
+      static bool getHashConsing() { return hash_consing; }
+
+      /// Number of hash-consing lookups since the last reset
+      static casadi_int getHashConsingLookups();
+
+      /// Number of hash-consing lookups that returned an existing expression
+      static casadi_int getHashConsingHits();
+
+      /// Reset the hash-consing counters
+      static void resetHashConsingStats();
+
   };
 
 } // namespace casadi
@@ -50,6 +50,12 @@ namespace casadi {
       }
     };
 
+  bool ImporterInternal::has_jit_function(const std::string& compiler) {
+    // Built-in importers only load compiled code
+    if (compiler=="none" || compiler=="dll") return false;
+    return getPlugin(compiler).exposed.jit_function;
+  }
+
   void ImporterInternal::construct(const Dict& opts) {
     // Sanitize dictionary is needed
     if (!Options::is_sane(opts)) {
@@ -76,8 +76,14 @@ namespace casadi {
 
     virtual void finalize() {}
 
-    // No static functions exposed
-    struct Exposed{ };
+    // Static properties exposed by the plugins
+    struct Exposed{
+      /// Does the plugin compile functions directly, cf. jit_function?
+      bool jit_function = false;
+    };
+
+    /// Does a compiler plugin compile functions directly, cf. jit_function?
+    static bool has_jit_function(const std::string& compiler);
 
     /// Collection of solvers
     static std::map<std::string, Plugin> solvers_;
@@ -94,6 +100,12 @@ namespace casadi {
     /// Get a function pointer for numerical evaluation
     virtual signal_t get_function(const std::string& symname) { return nullptr;}
 
+    /** \brief Get a function pointer for numerical evaluation of f, compiled
+     * directly from its instructions rather than from the generated source code.
+     * A null pointer means that the plugin does not compile functions directly.
+     */
+    virtual signal_t jit_function(const Function& f) { return nullptr;}
+
     /// Get a function pointer for numerical evaluation
     bool has_function(const std::string& symname) const;
 
@@ -260,7 +260,10 @@ namespace casadi {
         "Specifies, for each grid dimenion, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; (default when #knots<=100), "
         "'exact' uses floored division (only for uniform grids), "
-        "'binary' uses a binary search. (default when #knots>100)."}},
+        "'binary' uses a binary search, "
+        "'bucket' uses a precomputed table of equal-width buckets (only for fixed grids). "
+        "By default, 'bucket' is used when #knots>100 and no bucket holds more than "
+        "log2(#knots) knots, 'binary' otherwise."}},
       {"inline",
        {OT_BOOL,
         "Implement the lookup table in MX primitives. "
@@ -328,6 +331,34 @@ namespace casadi {
         }
       }
     }
+
+    // Bucket tables, stored after the lookup modes
+    casadi_int n_dim = offset.size()-1;
+    for (casadi_int i=0;i<n_dim;++i) {
+      bool is_auto = modes.empty() || modes[i]=="auto";
+      if (ret[i]!=LOOKUP_BUCKET && !(is_auto && ret[i]==LOOKUP_BINARY)) continue;
+      // Grid not known in advance
+      if (knots.empty()) {
+        ret[i] = LOOKUP_BINARY;
+        continue;
+      }
+      casadi_int m_left  = margin_left.empty() ? 0 : margin_left[i];
+      casadi_int m_right = margin_right.empty() ? 0 : margin_right[i];
+      std::vector<double> grid(
+          knots.begin()+offset[i]+m_left,
+          knots.begin()+offset[i+1]-m_right);
+      casadi_int max_scan;
+      std::vector<casadi_int> table = Low::bucket_table(grid, max_scan);
+      // Automatic choice: no worse than a binary search
+      double log2_n = std::log2(static_cast<double>(grid.size()));
+      if (table.empty() || (is_auto && max_scan>log2_n)) {
+        ret[i] = LOOKUP_BINARY;
+        continue;
+      }
+      // Negative entry: offset to the table
+      ret[i] = i - static_cast<casadi_int>(ret.size());
+      ret.insert(ret.end(), table.begin(), table.end());
+    }
     return ret;
   }
 
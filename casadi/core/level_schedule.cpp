@@ -0,0 +1,114 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "level_schedule.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace casadi {
+
+  LevelSchedule::LevelSchedule(const Sparsity& sp_r, bool tr) {
+    casadi_int n = sp_r.size2();
+    // The dependencies of unknown i are column i of R (tr) or row i of R
+    vector<casadi_int> mapping;
+    Sparsity sp_dep = tr ? sp_r : sp_r.transpose(mapping);
+    if (tr) mapping = range(sp_r.nnz());
+    const casadi_int *colind = sp_dep.colind(), *row = sp_dep.row();
+    // Level of each unknown, in order of dependency
+    vector<casadi_int> level(n);
+    casadi_int n_level = 0;
+    colind_.resize(n+1);
+    colind_[0] = 0;
+    diag_.resize(n, -1);
+    for (casadi_int i1=0; i1<n; ++i1) {
+      casadi_int i = tr ? i1 : n-1-i1;
+      casadi_int l = 0;
+      for (casadi_int k=colind[i]; k<colind[i+1]; ++k) {
+        casadi_int r = row[k];
+        if (r==i) {
+          diag_[i] = mapping[k];
+        } else {
+          l = max(l, level[r]+1);
+        }
+      }
+      level[i] = l;
+      n_level = max(n_level, l+1);
+    }
+    // Dependencies, without the diagonal
+    for (casadi_int i=0; i<n; ++i) {
+      for (casadi_int k=colind[i]; k<colind[i+1]; ++k) {
+        if (row[k]!=i) {
+          row_.push_back(row[k]);
+          nz_.push_back(mapping[k]);
+        }
+      }
+      colind_[i+1] = row_.size();
+    }
+    // Sort the unknowns by level
+    lev_ptr_.resize(n_level+1, 0);
+    for (casadi_int i=0; i<n; ++i) lev_ptr_[level[i]+1]++;
+    for (casadi_int l=0; l<n_level; ++l) lev_ptr_[l+1] += lev_ptr_[l];
+    lev_ind_.resize(n);
+    vector<casadi_int> pos(lev_ptr_.begin(), lev_ptr_.end()-1);
+    for (casadi_int i=0; i<n; ++i) lev_ind_[pos[level[i]]++] = i;
+  }
+
+  void LevelSchedule::solve_row(casadi_int i, const double* nz_r, double* x,
+                                casadi_int nb) const {
+    double* xi = x + nb*i;
+    for (casadi_int k=colind_[i]; k<colind_[i+1]; ++k) {
+      double a = nz_r[nz_[k]];
+      const double* xr = x + nb*row_[k];
+      for (casadi_int j=0; j<nb; ++j) xi[j] -= a*xr[j];
+    }
+    if (diag_[i]>=0) {
+      double d = nz_r[diag_[i]];
+      for (casadi_int j=0; j<nb; ++j) xi[j] /= d;
+    }
+  }
+
+  void LevelSchedule::solve(const double* nz_r, double* x, casadi_int nb) const {
+    // Levels with fewer unknowns are not worth distributing
+    const casadi_int min_level_size = 64;
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = pool.size();
+    for (casadi_int l=0; l<n_level(); ++l) {
+      const casadi_int* ind = get_ptr(lev_ind_) + lev_ptr_[l];
+      casadi_int sz = lev_ptr_[l+1] - lev_ptr_[l];
+      if (nw>1 && sz>=min_level_size) {
+        pool.run(sz, nw, [&](casadi_int i, casadi_int w) {
+          solve_row(ind[i], nz_r, x, nb);
+        });
+      } else {
+        for (casadi_int i=0; i<sz; ++i) solve_row(ind[i], nz_r, x, nb);
+      }
+    }
+  }
+
+} // namespace casadi
@@ -0,0 +1,87 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_LEVEL_SCHEDULE_HPP
+#define CASADI_LEVEL_SCHEDULE_HPP
+
+#include "sparsity.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Level schedule for a sparse triangular solve
+
+      Solves with an upper triangular factor R, given as a sparsity pattern
+      with nonzeros supplied at solve time. With tr, R'*x = b is solved
+      (forward substitution), otherwise R*x = b (backward substitution).
+      Without diagonal entries, R is assumed to have a unit diagonal.
+
+      The unknowns are grouped into levels: an unknown only depends on unknowns
+      in earlier levels. The unknowns of a level are computed concurrently on
+      the shared ThreadPool. Each unknown is computed from its dependencies
+      ("pull" form), so no two workers write to the same entry.
+
+  */
+  class CASADI_EXPORT LevelSchedule {
+  public:
+    /// Default constructor
+    LevelSchedule() {}
+
+    /// Analyse the pattern of an upper triangular factor
+    LevelSchedule(const Sparsity& sp_r, bool tr);
+
+    /// Number of levels
+    casadi_int n_level() const { return lev_ptr_.size()-1;}
+
+    /** \brief Solve in-place for nb right-hand-sides, stored interleaved
+     *
+     * x[nb*i+j] is row i of right-hand-side j. nz_r are the nonzeros of R.
+     */
+    void solve(const double* nz_r, double* x, casadi_int nb) const;
+
+  private:
+    /// Dependencies of each unknown, excluding the diagonal
+    std::vector<casadi_int> colind_, row_;
+
+    /// Index of each dependency in the nonzeros of R
+    std::vector<casadi_int> nz_;
+
+    /// Index of the diagonal entry in the nonzeros of R, -1 if unit diagonal
+    std::vector<casadi_int> diag_;
+
+    /// Unknowns in level l: lev_ind_[lev_ptr_[l]], ..., lev_ind_[lev_ptr_[l+1]-1]
+    std::vector<casadi_int> lev_ptr_, lev_ind_;
+
+    /// Compute unknown i
+    void solve_row(casadi_int i, const double* nz_r, double* x, casadi_int nb) const;
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_LEVEL_SCHEDULE_HPP
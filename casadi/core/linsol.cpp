@@ -111,6 +111,9 @@ namespace casadi {
     if (A==nullptr) return 1;
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
 
+    // Keep the pivot sequence of a reused factorization
+    if (m->is_nfact && (*this)->reuse_tol_>0) return 0;
+
     // Factorization will be needed after this step
     m->is_sfact = m->is_nfact = false;
 
@@ -138,6 +141,12 @@ namespace casadi {
       if (sfact(A, mem)) return 1;
     }
 
+    // Keep the factorization, solve refines or refactorizes
+    if (m->is_nfact && (*this)->reuse_tol_>0) {
+      m->is_stale = true;
+      return 0;
+    }
+
     m->is_nfact = false;
     if (m->t_total) m->fstats.at("nfact").tic();
     if ((*this)->nfact(m, A)) return 1;
@@ -154,7 +163,9 @@ namespace casadi {
   }
 
   casadi_int Linsol::neig(const double* A, int mem) const {
-    return (*this)->neig((*this)->memory(mem), A);
+    auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
+    if (m->is_stale && (*this)->refactor(m, A)) return -1;
+    return (*this)->neig(m, A);
   }
 
   casadi_int Linsol::rank(const DM& A) const {
@@ -165,14 +176,26 @@ namespace casadi {
   }
 
   casadi_int Linsol::rank(const double* A, int mem) const {
-    return (*this)->rank((*this)->memory(mem), A);
+    auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
+    if (m->is_stale && (*this)->refactor(m, A)) return -1;
+    return (*this)->rank(m, A);
   }
 
   int Linsol::solve(const double* A, double* x, casadi_int nrhs, bool tr, int mem) const {
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
     if (m->t_total) m->fstats.at("solve").tic();
-    int ret = (*this)->solve(m, A, x, nrhs, tr);
+    int ret = 0;
+    if (m->is_stale) {
+      // Iterative refinement with the old factorization
+      if ((*this)->solve_refine(m, A, x, nrhs, tr)) {
+        // Not accurate enough, refactorize and solve again
+        casadi_copy(get_ptr(m->b), (*this)->nrow()*nrhs, x);
+        ret = (*this)->refactor(m, A) || (*this)->solve(m, A, x, nrhs, tr);
+      }
+    } else {
+      ret = (*this)->solve(m, A, x, nrhs, tr);
+    }
     if (m->t_total) m->fstats.at("solve").toc();
     return ret;
   }
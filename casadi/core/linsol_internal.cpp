@@ -35,10 +35,38 @@ namespace casadi {
   LinsolInternal::~LinsolInternal() {
   }
 
+  const Options LinsolInternal::options_
+  = {{&ProtoFunction::options_},
+     {{"reuse_tol",
+       {OT_DOUBLE,
+        "Keep the numeric factorization of an earlier matrix as long as "
+        "iterative refinement brings the relative residual below this tolerance. "
+        "The pivot sequence is kept when refactorizing. Default 0: no reuse"}},
+      {"max_refine",
+       {OT_INT,
+        "Maximum number of iterative refinement steps with a reused factorization "
+        "[default 3]"}}
+     }
+  };
+
   void LinsolInternal::init(const Dict& opts) {
     // Call the base class initializer
     ProtoFunction::init(opts);
 
+    // Default options
+    reuse_tol_ = 0;
+    max_refine_ = 3;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="reuse_tol") {
+        reuse_tol_ = op.second;
+      } else if (op.first=="max_refine") {
+        max_refine_ = op.second;
+      }
+    }
+    casadi_assert(reuse_tol_>=0, "Option 'reuse_tol' must be nonnegative");
+    casadi_assert(max_refine_>=0, "Option 'max_refine' must be nonnegative");
   }
 
   void LinsolInternal::disp(ostream &stream, bool more) const {
@@ -70,6 +98,54 @@ namespace casadi {
     casadi_error("'solve' not defined for " + class_name());
   }
 
+  int LinsolInternal::solve_refine(void* mem, const double* A, double* x,
+                                   casadi_int nrhs, bool tr) const {
+    auto m = static_cast<LinsolMemory*>(mem);
+    casadi_int n = nrow(), sz = n*nrhs;
+    m->b.resize(sz);
+    m->r.resize(sz);
+    double *b = get_ptr(m->b), *r = get_ptr(m->r);
+    // Save the right-hand-sides
+    casadi_copy(x, sz, b);
+    double b_norm = casadi_norm_inf(sz, b);
+    // Solve with the old factorization
+    if (solve(mem, A, x, nrhs, tr)) return 1;
+    for (casadi_int it=0; ; ++it) {
+      // Residual r = b - A*x
+      casadi_clear(r, sz);
+      for (casadi_int k=0; k<nrhs; ++k) casadi_mv(A, sp_, x + k*n, r + k*n, tr);
+      for (casadi_int i=0; i<sz; ++i) r[i] = b[i] - r[i];
+      if (casadi_norm_inf(sz, r) <= reuse_tol_*b_norm) {
+        m->n_reuse++;
+        return 0;
+      }
+      if (it==max_refine_) return 1;
+      // Correction using the old factorization
+      if (solve(mem, A, r, nrhs, tr)) return 1;
+      casadi_axpy(sz, 1., r, x);
+    }
+  }
+
+  int LinsolInternal::refactor(void* mem, const double* A) const {
+    auto m = static_cast<LinsolMemory*>(mem);
+    m->is_stale = false;
+    m->n_refactor++;
+    if (m->t_total) m->fstats.at("nfact").tic();
+    // Numeric factorization only, pivot again if this fails
+    int flag = nfact(mem, A) && (sfact(mem, A) || nfact(mem, A));
+    if (m->t_total) m->fstats.at("nfact").toc();
+    if (flag) m->is_sfact = m->is_nfact = false;
+    return flag;
+  }
+
+  Dict LinsolInternal::get_stats(void* mem) const {
+    Dict stats = ProtoFunction::get_stats(mem);
+    auto m = static_cast<LinsolMemory*>(mem);
+    stats["n_reuse"] = m->n_reuse;
+    stats["n_refactor"] = m->n_refactor;
+    return stats;
+  }
+
 #if 0
   casadi_int LinsolInternal::factorize(void* mem, const double* A) const {
     // Symbolic factorization, if needed
@@ -125,11 +201,17 @@ namespace casadi {
 
   void LinsolInternal::serialize_body(SerializingStream &s) const {
     ProtoFunction::serialize_body(s);
+    s.version("LinsolInternal", 1);
     s.pack("LinsolInternal::sp", sp_);
+    s.pack("LinsolInternal::reuse_tol", reuse_tol_);
+    s.pack("LinsolInternal::max_refine", max_refine_);
   }
 
   LinsolInternal::LinsolInternal(DeserializingStream& s) : ProtoFunction(s) {
+    s.version("LinsolInternal", 1);
     s.unpack("LinsolInternal::sp", sp_);
+    s.unpack("LinsolInternal::reuse_tol", reuse_tol_);
+    s.unpack("LinsolInternal::max_refine", max_refine_);
   }
 
   ProtoFunction* LinsolInternal::deserialize(DeserializingStream& s) {
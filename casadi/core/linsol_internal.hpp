@@ -38,8 +38,18 @@ namespace casadi {
     // Current state of factorization
     bool is_sfact, is_nfact;
 
+    // Factorization is of an earlier matrix, solves use iterative refinement
+    bool is_stale;
+
+    // Right-hand-sides and residuals for iterative refinement
+    std::vector<double> b, r;
+
+    // Solves with a reused factorization, refactorizations after failed refinement
+    casadi_int n_reuse, n_refactor;
+
     // Constructor
-    LinsolMemory() : is_sfact(false), is_nfact(false) {}
+    LinsolMemory() : is_sfact(false), is_nfact(false), is_stale(false),
+      n_reuse(0), n_refactor(0) {}
   };
 
   /** Internal class
@@ -60,6 +70,12 @@ namespace casadi {
     /** \brief  Print more */
     virtual void disp_more(std::ostream& stream) const {}
 
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
     /// Initialize
     void init(const Dict& opts) override;
 
@@ -97,6 +113,18 @@ namespace casadi {
     // Solve numerically
     virtual int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const;
 
+    /** \brief Solve with a factorization of an earlier matrix
+     * Iterative refinement with A, returns 1 if the relative residual does not
+     * drop below reuse_tol, with the right-hand-sides saved in the memory
+     */
+    int solve_refine(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const;
+
+    /// Refactorize a stale factorization, keeping the pivot sequence if possible
+    int refactor(void* mem, const double* A) const;
+
+    /** \brief Get all statistics */
+    Dict get_stats(void* mem) const override;
+
     /// Number of negative eigenvalues
     virtual casadi_int neig(void* mem, const double* A) const;
 
@@ -140,6 +168,12 @@ namespace casadi {
     // Sparsity pattern of the linear system
     Sparsity sp_;
 
+    ///@{
+    // Options
+    double reuse_tol_;
+    casadi_int max_refine_;
+    ///@}
+
   protected:
     /** \brief Deserializing constructor */
     explicit LinsolInternal(DeserializingStream& s);
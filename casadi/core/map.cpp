@@ -24,16 +24,10 @@
 
 
 #include "map.hpp"
+#include "sx_function.hpp"
+#include "thread_pool.hpp"
 #include "serializing_stream.hpp"
 
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
-
 using namespace std;
 
 namespace casadi {
@@ -101,6 +95,12 @@ namespace casadi {
     alloc_res(f_.sz_res());
     alloc_w(f_.sz_w());
     alloc_iw(f_.sz_iw());
+
+    // Allocate sufficient memory for batched evaluation
+    if (f_.is_a("SXFunction", false)) {
+      const SXFunction* f = f_.get<SXFunction>();
+      if (f->has_eval_batch()) alloc_w(f->sz_w_batch());
+    }
   }
 
   template<typename T>
@@ -281,6 +281,13 @@ namespace casadi {
   }
 
   int Map::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    // SX functions can be evaluated for a block of points per instruction dispatch
+    if (f_.is_a("SXFunction", false)) {
+      const SXFunction* f = f_.get<SXFunction>();
+      if (f->has_eval_batch() && sz_w()>=f->sz_w_batch()) {
+        return f->eval_batch(arg, res, w, n_);
+      }
+    }
     // This checkout/release dance is an optimization.
     // Could also use the thread-safe variant f_(arg1, res1, iw, w)
     // in Map::eval_gen
@@ -429,29 +436,21 @@ namespace casadi {
 #ifndef CASADI_WITH_THREAD
     return Map::eval(arg, res, iw, w, mem);
 #else // CASADI_WITH_THREAD
-    // Checkout memory objects
-    std::vector< scoped_checkout<Function> > ind; ind.reserve(n_);
-    for (casadi_int i=0; i<n_; ++i) ind.emplace_back(f_);
+    // Shared pool of worker threads
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = std::min(n_, pool.size());
+
+    // Checkout one memory object per worker
+    std::vector< scoped_checkout<Function> > ind; ind.reserve(nw);
+    for (casadi_int i=0; i<nw; ++i) ind.emplace_back(f_);
 
     // Allocate space for return values
     std::vector<int> ret_values(n_);
 
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int i=0; i<n_; ++i) {
-      // Why the lambda function?
-      // Because it was the first iteration to pass tests on MingGW
-      // using mingw-std-threads.
-      threads.emplace_back(
-        [i](const Function& f, const double** arg, double** res,
-            casadi_int* iw, double* w, casadi_int ind, int& ret) {
-              ThreadsWork(f, i, arg, res, iw, w, ind, ret);
-            },
-        std::ref(f_), arg, res, iw, w, casadi_int(ind[i]), std::ref(ret_values[i]));
-    }
-
-    // Join threads
-    for (auto && th : threads) th.join();
+    // Distribute the evaluations over the workers
+    pool.run(n_, nw, [&](casadi_int i, casadi_int k) {
+      ThreadsWork(f_, i, arg, res, iw, w, ind[k], ret_values[i]);
+    });
 
     // Anticipate success
     int ret = 0;
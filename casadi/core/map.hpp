@@ -194,9 +194,9 @@ namespace casadi {
     explicit OmpMap(DeserializingStream& s) : Map(s) {}
   };
 
-  /** A map Evaluate in parallel using std::thread
-      Note: Do not use this class with much more than the intended number of
-      threads for the parallel evaluation as it will cause excessive memory use.
+  /** A map Evaluate in parallel using the shared pool of std::thread workers
+      The evaluations are distributed over at most GlobalOptions::num_threads workers,
+      each using a single memory object of the mapped function.
 
       \author Joris Gillis
       \date 2018
@@ -0,0 +1,72 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace casadi {
+
+  MappedFile::MappedFile(const std::string& fname) : map_(nullptr), size_(0), open_(false) {
+#ifndef _WIN32
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd>=0) {
+      struct stat st;
+      if (fstat(fd, &st)==0 && st.st_size>0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p!=MAP_FAILED) {
+          map_ = static_cast<char*>(p);
+          size_ = st.st_size;
+          madvise(p, size_, MADV_SEQUENTIAL);
+          open_ = true;
+        }
+      }
+      close(fd);
+      if (open_) return;
+    }
+#endif // _WIN32
+    // Fall back to reading the whole file
+    ifstream s(fname, ios_base::binary | ios::in);
+    if (!s.good()) return;
+    open_ = true;
+    buf_.assign(istreambuf_iterator<char>(s), istreambuf_iterator<char>());
+  }
+
+  MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (map_) munmap(map_, size_);
+#endif // _WIN32
+  }
+
+} // namespace casadi
@@ -0,0 +1,79 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_MAPPED_FILE_HPP
+#define CASADI_MAPPED_FILE_HPP
+
+#include "casadi_common.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Read-only view of the contents of a file
+
+      On POSIX systems, the file is memory-mapped, so that its pages come from
+      the page cache shared with all other processes that map the same file.
+      Elsewhere, or if the file cannot be mapped, it is read into memory.
+
+  */
+  class CASADI_EXPORT MappedFile {
+  public:
+    /// Open a file, check with is_open()
+    explicit MappedFile(const std::string& fname);
+
+    /// Destructor
+    ~MappedFile();
+
+    /// Could the file be opened
+    bool is_open() const { return open_;}
+
+    /// Contents of the file
+    const char* data() const { return map_ ? map_ : buf_.data();}
+
+    /// Size of the file in bytes
+    size_t size() const { return map_ ? size_ : buf_.size();}
+
+  private:
+    /// No copies
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Memory-mapped contents, if any
+    char* map_;
+    size_t size_;
+
+    /// Contents read into memory otherwise
+    std::vector<char> buf_;
+
+    /// Could the file be opened
+    bool open_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_MAPPED_FILE_HPP
@@ -1130,9 +1130,13 @@ namespace casadi {
     } else {
       // Carry out the matrix product
       Matrix<Scalar> ret = z;
-      std::vector<Scalar> work(x.size1());
-      casadi_mtimes(x.ptr(), x.sparsity(), y.ptr(), y.sparsity(),
-                    ret.ptr(), ret.sparsity(), get_ptr(work), false);
+      if (x.is_dense() && y.is_dense() && ret.is_dense()) {
+        casadi_mtimes_dense(x.ptr(), x.size1(), x.size2(), y.ptr(), y.size2(), ret.ptr());
+      } else {
+        std::vector<Scalar> work(x.size1());
+        casadi_mtimes(x.ptr(), x.sparsity(), y.ptr(), y.sparsity(),
+                      ret.ptr(), ret.sparsity(), get_ptr(work), false);
+      }
       return ret;
     }
   }
@@ -1979,7 +1983,8 @@ namespace casadi {
     casadi_assert(beta.is_vector() && beta.numel()==ncol, "'beta' has wrong dimension");
     casadi_assert(prinv.size()==r.size1(), "'pinv' has wrong dimension");
     // Work vector
-    std::vector<Scalar> w(nrow+ncol);
+    casadi_int nb = std::min(nrhs, casadi_int(8));
+    std::vector<Scalar> w(std::max(nrow+ncol, std::max(ncol, v.size1())*nb));
     // Return value
     Matrix<Scalar> x = densify(b);
     casadi_qr_solve(x.ptr(), nrhs, tr, v.sparsity(), v.ptr(), r.sparsity(), r.ptr(),
@@ -2057,7 +2062,7 @@ namespace casadi {
     casadi_assert(D.is_vector() && D.numel()==n, "'D' has wrong dimension");
     // Solve for all right-hand-sides
     Matrix<Scalar> x = densify(b);
-    std::vector<Scalar> w(n);
+    std::vector<Scalar> w(n*std::min(nrhs, casadi_int(8)));
     casadi_ldl_solve(x.ptr(), nrhs, LT.sparsity(), LT.ptr(), D.ptr(), get_ptr(p), get_ptr(w));
     return x;
   }
@@ -0,0 +1,103 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "memory_pool.hpp"
+#include "casadi_misc.hpp"
+
+using namespace std;
+namespace casadi {
+
+  MemoryPool::MemoryPool() : size_(0), head_(0) {
+    for (auto&& c : chunks_) c.store(nullptr, memory_order_relaxed);
+  }
+
+  MemoryPool::~MemoryPool() {
+    clear();
+  }
+
+  MemoryPool::Slot& MemoryPool::slot(int ind) const {
+    // Chunk k starts at index CHUNK0*(2^k - 1)
+    unsigned v = static_cast<unsigned>(ind)/CHUNK0 + 1;
+    int k = 0;
+    while (v >>= 1) k++;
+    Slot* c = chunks_[k].load(memory_order_acquire);
+    return c[ind - CHUNK0*((1 << k) - 1)];
+  }
+
+  int MemoryPool::pop() {
+    uint64_t h = head_.load(memory_order_acquire);
+    while (true) {
+      int top = static_cast<int>(h & 0xffffffffu) - 1;
+      if (top<0) return -1;
+      int next = slot(top).next.load(memory_order_relaxed);
+      uint64_t nh = ((h >> 32) + 1) << 32 | static_cast<uint32_t>(next + 1);
+      if (head_.compare_exchange_weak(h, nh, memory_order_acq_rel, memory_order_acquire)) {
+        return top;
+      }
+    }
+  }
+
+  void MemoryPool::push(int ind) {
+    Slot& s = slot(ind);
+    uint64_t h = head_.load(memory_order_relaxed);
+    uint64_t nh;
+    do {
+      s.next.store(static_cast<int>(h & 0xffffffffu) - 1, memory_order_relaxed);
+      nh = ((h >> 32) + 1) << 32 | static_cast<uint32_t>(ind + 1);
+    } while (!head_.compare_exchange_weak(h, nh, memory_order_release, memory_order_relaxed));
+  }
+
+  int MemoryPool::add(void* m) {
+    int ind = size_.load(memory_order_relaxed);
+    unsigned v = static_cast<unsigned>(ind)/CHUNK0 + 1;
+    int k = 0;
+    while (v >>= 1) k++;
+    casadi_assert(k<MAX_CHUNKS, "Too many memory objects");
+    if (chunks_[k].load(memory_order_relaxed)==nullptr) {
+      Slot* c = new Slot[CHUNK0 << k];
+      chunks_[k].store(c, memory_order_release);
+    }
+    Slot& s = slot(ind);
+    s.mem.store(m, memory_order_relaxed);
+    s.next.store(-1, memory_order_relaxed);
+    size_.store(ind+1, memory_order_release);
+    return ind;
+  }
+
+  void* MemoryPool::at(int ind) const {
+    casadi_assert(ind>=0 && ind<size(), "Memory object " + str(ind) + " out of range");
+    return slot(ind).mem.load(memory_order_acquire);
+  }
+
+  void MemoryPool::clear() {
+    for (auto&& c : chunks_) {
+      delete[] c.load(memory_order_relaxed);
+      c.store(nullptr, memory_order_relaxed);
+    }
+    size_.store(0, memory_order_relaxed);
+    head_.store(0, memory_order_relaxed);
+  }
+
+} // namespace casadi
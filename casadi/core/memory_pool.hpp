@@ -0,0 +1,101 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MEMORY_POOL_HPP
+#define CASADI_MEMORY_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <atomic>
+#include <cstdint>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Pool of memory objects with lock-free checkout and release
+
+      Objects are identified by their index, which is stable for the lifetime of
+      the pool. Unused indices are kept on a lock-free stack (Treiber stack with
+      a version tag against ABA), so that checkout and release of existing
+      objects do not take a lock. Objects are stored in chunks of geometrically
+      increasing size which are never moved, so that lookup by index is lock-free
+      too. Adding objects must be serialized by the caller.
+
+  */
+  class CASADI_EXPORT MemoryPool {
+  public:
+    /// Constructor
+    MemoryPool();
+
+    /// Destructor, the objects themselves are not freed
+    ~MemoryPool();
+
+    /// Get an unused index, -1 if there is none
+    int pop();
+
+    /// Mark an index as unused
+    void push(int ind);
+
+    /// Add a new (checked out) object, not thread-safe w.r.t. other calls to add
+    int add(void* m);
+
+    /// Number of objects
+    int size() const { return size_.load(std::memory_order_acquire);}
+
+    /// Access an object
+    void* at(int ind) const;
+
+    /// Remove all objects
+    void clear();
+
+  private:
+    /// Storage for one object
+    struct Slot {
+      std::atomic<void*> mem;
+      std::atomic<int> next;
+    };
+
+    // Chunk k holds CHUNK0*2^k slots
+    static const int CHUNK0 = 16;
+    static const int MAX_CHUNKS = 26;
+
+    /// Locate a slot
+    Slot& slot(int ind) const;
+
+    /// Slot storage
+    std::atomic<Slot*> chunks_[MAX_CHUNKS];
+
+    /// Number of objects
+    std::atomic<int> size_;
+
+    /// Top of the unused stack (index+1, 0 if empty) in the low 32 bits, version tag above
+    std::atomic<uint64_t> head_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_MEMORY_POOL_HPP
@@ -122,6 +122,24 @@ namespace casadi {
                           g.work(res[0], nnz()), sparsity(), "w", false) << '\n';
   }
 
+  int DenseMultiplication::
+  eval(const double** arg, double** res, casadi_int* iw, double* w) const {
+    return eval_gen<double>(arg, res, iw, w);
+  }
+
+  int DenseMultiplication::
+  eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
+    return eval_gen<SXElem>(arg, res, iw, w);
+  }
+
+  template<typename T>
+  int DenseMultiplication::eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const {
+    if (arg[0]!=res[0]) copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
+    casadi_mtimes_dense(arg[1], dep(1).size1(), dep(1).size2(),
+                        arg[2], dep(2).size2(), res[0]);
+    return 0;
+  }
+
   void DenseMultiplication::
   generate(CodeGenerator& g,
            const std::vector<casadi_int>& arg, const std::vector<casadi_int>& res) const {
@@ -131,18 +149,10 @@ namespace casadi {
                           g.work(res[0], nnz())) << '\n';
     }
 
-    casadi_int nrow_x = dep(1).size1(), nrow_y = dep(2).size1(), ncol_y = dep(2).size2();
-    g.local("rr", "casadi_real", "*");
-    g.local("ss", "casadi_real", "*");
-    g.local("tt", "casadi_real", "*");
-    g.local("i", "casadi_int");
-    g.local("j", "casadi_int");
-    g.local("k", "casadi_int");
-    g << "for (i=0, rr=" << g.work(res[0], nnz()) <<"; i<" << ncol_y << "; ++i)"
-      << " for (j=0; j<" << nrow_x << "; ++j, ++rr)"
-      << " for (k=0, ss=" << g.work(arg[1], dep(1).nnz()) << "+j, tt="
-      << g.work(arg[2], dep(2).nnz()) << "+i*" << nrow_y << "; k<" << nrow_y << "; ++k)"
-      << " *rr += ss[k*" << nrow_x << "]**tt++;\n";
+    // Perform dense matrix multiplication
+    g << g.mtimes(g.work(arg[1], dep(1).nnz()), dep(1).size1(), dep(1).size2(),
+                  g.work(arg[2], dep(2).nnz()), dep(2).size2(),
+                  g.work(res[0], nnz())) << '\n';
   }
 
   void Multiplication::serialize_type(SerializingStream& s) const {
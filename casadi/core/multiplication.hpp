@@ -121,6 +121,19 @@ namespace casadi {
     /** \brief  Destructor */
     ~DenseMultiplication() override {}
 
+    /// Evaluate the function (template)
+    template<typename T>
+    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
+
+    /// Evaluate the function symbolically (SX)
+    int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
+
+    /** \brief Get required length of w field */
+    size_t sz_w() const override { return 0;}
+
     /** \brief Generate code for the operation */
     void generate(CodeGenerator& g,
                   const std::vector<casadi_int>& arg,
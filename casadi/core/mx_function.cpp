@@ -29,6 +29,7 @@
 #include "casadi_interrupt.hpp"
 #include "io_instruction.hpp"
 #include "serializing_stream.hpp"
+#include "thread_pool.hpp"
 
 #include <stack>
 #include <typeinfo>
@@ -61,7 +62,11 @@ namespace casadi {
         "Default input values"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"task_parallel",
+       {OT_BOOL,
+        "Evaluate independent function calls and linear solves concurrently "
+        "on the shared thread pool, cf. GlobalOptions::setNumThreads"}}
      }
   };
 
@@ -69,6 +74,7 @@ namespace casadi {
     Dict opts = FunctionInternal::generate_options(is_temp);
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
+    opts["task_parallel"] = task_parallel_;
     return opts;
   }
 
@@ -103,6 +109,7 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    task_parallel_ = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -110,6 +117,8 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="task_parallel") {
+        task_parallel_ = op.second;
       }
     }
 
@@ -218,10 +227,118 @@ namespace casadi {
       }
     }
 
+    // Level of each element: its arguments are computed at lower levels
+    vector<casadi_int> level(algorithm_.size(), 0);
+    if (task_parallel_) {
+      vector<casadi_int> node_level(nodes.size(), 0), node_alg(nodes.size(), -1);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        const AlgEl& e = algorithm_[k];
+        for (casadi_int a : e.arg) {
+          if (a>=0) level[k] = max(level[k], node_level[a]+1);
+        }
+        for (casadi_int r : e.res) {
+          if (r>=0) {
+            node_level[r] = level[k];
+            node_alg[r] = k;
+          }
+        }
+      }
+      // Elements without arguments (inputs, constants) as late as possible
+      vector<casadi_int> latest(algorithm_.size(), -1);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        for (casadi_int a : algorithm_[k].arg) {
+          if (a<0) continue;
+          casadi_int p = node_alg[a];
+          if (algorithm_[p].arg.empty()) {
+            latest[p] = latest[p]<0 ? level[k]-1 : min(latest[p], level[k]-1);
+          }
+        }
+      }
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        if (latest[k]>=0) level[k] = latest[k];
+      }
+    }
+
+    // Group the levels into stages, a level with at least two expensive
+    // operations is a parallel stage, the other levels are evaluated serially
+    stage_ptr_.clear();
+    stage_parallel_.clear();
+    n_worker_ = 1;
+    if (task_parallel_) {
+      // Sort the elements by level
+      casadi_int n_level = 0;
+      for (casadi_int l : level) n_level = max(n_level, l+1);
+      vector<casadi_int> lev_ptr(n_level+1, 0), n_expensive(n_level, 0);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        lev_ptr[level[k]+1]++;
+        if (algorithm_[k].op==OP_CALL || algorithm_[k].op==OP_SOLVE) n_expensive[level[k]]++;
+      }
+      for (casadi_int l=0; l<n_level; ++l) lev_ptr[l+1] += lev_ptr[l];
+      vector<casadi_int> order(algorithm_.size());
+      vector<casadi_int> next(lev_ptr.begin(), lev_ptr.end()-1);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) order[next[level[k]]++] = k;
+      // Form the stages
+      stage_ptr_.push_back(0);
+      for (casadi_int l=0; l<n_level; ++l) {
+        bool par = n_expensive[l]>1;
+        // Close the current serial stage
+        if (par && stage_ptr_.back()<lev_ptr[l]) {
+          stage_ptr_.push_back(lev_ptr[l]);
+          stage_parallel_.push_back(false);
+        }
+        if (par) {
+          stage_ptr_.push_back(lev_ptr[l+1]);
+          stage_parallel_.push_back(true);
+          n_worker_ = max(n_worker_, lev_ptr[l+1]-lev_ptr[l]);
+        }
+      }
+      if (stage_ptr_.back()<algorithm_.size()) {
+        stage_ptr_.push_back(algorithm_.size());
+        stage_parallel_.push_back(false);
+      }
+      if (n_worker_==1) {
+        // Without parallel stages, keep the original order
+        stage_ptr_.clear();
+        stage_parallel_.clear();
+      } else {
+        // Serial stages in the original (depth-first) order
+        for (casadi_int s=0; s<stage_parallel_.size(); ++s) {
+          if (!stage_parallel_[s]) {
+            sort(order.begin()+stage_ptr_[s], order.begin()+stage_ptr_[s+1]);
+          }
+        }
+        // Permute the algorithm into stage order, so that all passes over the
+        // algorithm (evaluation, derivatives, codegen, ...) use the same order
+        vector<casadi_int> inv_order(order.size());
+        vector<AlgEl> alg(order.size());
+        for (casadi_int i=0; i<order.size(); ++i) {
+          inv_order[order[i]] = i;
+          alg[i] = algorithm_[order[i]];
+        }
+        algorithm_.swap(alg);
+        for (auto&& e : symb_loc) e.first = inv_order[e.first];
+        // Step at which each element is evaluated, shared within a parallel stage
+        for (casadi_int s=0, t=0; s<stage_parallel_.size(); ++s) {
+          for (casadi_int i=stage_ptr_[s]; i<stage_ptr_[s+1]; ++i) {
+            level[i] = stage_parallel_[s] ? t : t++;
+          }
+          if (stage_parallel_[s]) t++;
+        }
+      }
+      n_worker_ = min(n_worker_, ThreadPool::instance().size());
+      if (verbose_) {
+        casadi_message(str(std::count(stage_parallel_.begin(), stage_parallel_.end(), true))
+                       + " parallel stages, " + str(n_worker_) + " workers");
+      }
+    }
+
     // Place in the work vector for each of the nodes in the tree (overwrites the reference counter)
     vector<casadi_int>& place = place_in_alg; // Reuse memory as it is no longer needed
     place.resize(nodes.size());
 
+    // Last step at which each element of the work vector is accessed
+    vector<casadi_int> place_level;
+
     // Stack with unused elements in the work vector, sorted by sparsity pattern
     SPARSITY_MAP<casadi_int, stack<casadi_int> > unused_all;
 
@@ -229,7 +346,8 @@ namespace casadi {
     casadi_int worksize = 0;
 
     // Find a place in the work vector for the operation
-    for (auto&& e : algorithm_) {
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      AlgEl& e = algorithm_[k];
 
       // There are two tasks, allocate memory of the result and free the
       // memory off the arguments, order depends on whether inplace is possible
@@ -246,6 +364,9 @@ namespace casadi {
           casadi_int& ch_ind = e.arg[c];
           if (ch_ind>=0) {
 
+            // Elements at the same step may be evaluated concurrently
+            place_level[place[ch_ind]] = max(place_level[place[ch_ind]], level[k]);
+
             // Decrease reference count and add to the stack of
             // unused variables if the count hits zero
             casadi_int remaining = --refcount[ch_ind];
@@ -284,9 +405,12 @@ namespace casadi {
               // Get a reference to the stack for the current sparsity
               stack<casadi_int>& unused = unused_all[nnz];
 
-              // Try to reuse a variable from the stack if possible (last in, first out)
-              if (!unused.empty()) {
+              // Try to reuse a variable from the stack if possible (last in, first out),
+              // provided that it is no longer accessed at this step
+              if (!unused.empty()
+                  && (stage_ptr_.empty() || place_level[unused.top()] < level[k])) {
                 e.res[c] = place[e.res[c]] = unused.top();
+                place_level[e.res[c]] = level[k];
                 unused.pop();
                 continue; // Success, no new element needed in the work vector
               }
@@ -294,6 +418,7 @@ namespace casadi {
 
             // Allocate a new element in the work vector
             e.res[c] = place[e.res[c]] = worksize++;
+            place_level.push_back(level[k]);
           }
         }
       }
@@ -308,18 +433,28 @@ namespace casadi {
       }
     }
 
-    // Allocate work vectors (numeric)
+    // Scratch space needed by the operations
+    sz_arg_worker_ = sz_res_worker_ = sz_iw_worker_ = sz_w_worker_ = 0;
+    for (auto&& e : algorithm_) {
+      if (e.op!=OP_OUTPUT) {
+        sz_arg_worker_ = max(sz_arg_worker_, e.data->sz_arg());
+        sz_res_worker_ = max(sz_res_worker_, e.data->sz_res());
+        sz_iw_worker_ = max(sz_iw_worker_, e.data->sz_iw());
+        sz_w_worker_ = max(sz_w_worker_, e.data->sz_w());
+      }
+    }
+    alloc_arg(n_worker_*sz_arg_worker_);
+    alloc_res(n_worker_*sz_res_worker_);
+    alloc_iw(n_worker_*sz_iw_worker_);
+
+    // Allocate work vectors (numeric), after the scratch space of the workers
     workloc_.resize(worksize+1);
     fill(workloc_.begin(), workloc_.end(), -1);
-    size_t wind=0, sz_w=0;
+    size_t wind=0, sz_w=n_worker_*sz_w_worker_;
     for (auto&& e : algorithm_) {
       if (e.op!=OP_OUTPUT) {
         for (casadi_int c=0; c<e.res.size(); ++c) {
           if (e.res[c]>=0) {
-            alloc_arg(e.data->sz_arg());
-            alloc_res(e.data->sz_res());
-            alloc_iw(e.data->sz_iw());
-            sz_w = max(sz_w, e.data->sz_w());
             if (workloc_[e.res[c]] < 0) {
               workloc_[e.res[c]] = wind;
               wind += e.data->sparsity(c).nnz();
@@ -404,37 +539,67 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Evaluate the stages, concurrently within parallel stages
+    if (!stage_ptr_.empty()) {
+      ThreadPool& pool = ThreadPool::instance();
+      for (casadi_int s=0; s<stage_parallel_.size(); ++s) {
+        const AlgEl* e = get_ptr(algorithm_) + stage_ptr_[s];
+        casadi_int n = stage_ptr_[s+1] - stage_ptr_[s];
+        if (stage_parallel_[s]) {
+          // Each worker has its own scratch space
+          vector<int> flag(n, 0);
+          pool.run(n, n_worker_, [&](casadi_int i, casadi_int k) {
+            flag[i] = eval_el(e[i], arg, res,
+                              arg1 + k*sz_arg_worker_, res1 + k*sz_res_worker_,
+                              iw + k*sz_iw_worker_, w, w + k*sz_w_worker_);
+          });
+          for (int f : flag) if (f) return 1;
+        } else {
+          for (casadi_int i=0; i<n; ++i) {
+            if (eval_el(e[i], arg, res, arg1, res1, iw, w, w)) return 1;
+          }
+        }
+      }
+      return 0;
+    }
+
     // Evaluate all of the nodes of the algorithm:
     // should only evaluate nodes that have not yet been calculated!
     for (auto&& e : algorithm_) {
-      if (e.op==OP_INPUT) {
-        // Pass an input
-        double *w1 = w+workloc_[e.res.front()];
-        casadi_int nnz=e.data.nnz();
-        casadi_int i=e.data->ind();
-        casadi_int nz_offset=e.data->offset();
-        if (arg[i]==nullptr) {
-          fill(w1, w1+nnz, 0);
-        } else {
-          copy(arg[i]+nz_offset, arg[i]+nz_offset+nnz, w1);
-        }
-      } else if (e.op==OP_OUTPUT) {
-        // Get an output
-        double *w1 = w+workloc_[e.arg.front()];
-        casadi_int nnz=e.data->dep().nnz();
-        casadi_int i=e.data->ind();
-        casadi_int nz_offset=e.data->offset();
-        if (res[i]) copy(w1, w1+nnz, res[i]+nz_offset);
-      } else {
-        // Point pointers to the data corresponding to the element
-        for (casadi_int i=0; i<e.arg.size(); ++i)
-          arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : nullptr;
-        for (casadi_int i=0; i<e.res.size(); ++i)
-          res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : nullptr;
+      if (eval_el(e, arg, res, arg1, res1, iw, w, w)) return 1;
+    }
+    return 0;
+  }
 
-        // Evaluate
-        if (e.data->eval(arg1, res1, iw, w)) return 1;
+  int MXFunction::eval_el(const AlgEl& e, const double** arg, double** res,
+      const double** arg1, double** res1, casadi_int* iw, double* w, double* w1) const {
+    if (e.op==OP_INPUT) {
+      // Pass an input
+      double *wr = w+workloc_[e.res.front()];
+      casadi_int nnz=e.data.nnz();
+      casadi_int i=e.data->ind();
+      casadi_int nz_offset=e.data->offset();
+      if (arg[i]==nullptr) {
+        fill(wr, wr+nnz, 0);
+      } else {
+        copy(arg[i]+nz_offset, arg[i]+nz_offset+nnz, wr);
       }
+    } else if (e.op==OP_OUTPUT) {
+      // Get an output
+      double *wr = w+workloc_[e.arg.front()];
+      casadi_int nnz=e.data->dep().nnz();
+      casadi_int i=e.data->ind();
+      casadi_int nz_offset=e.data->offset();
+      if (res[i]) copy(wr, wr+nnz, res[i]+nz_offset);
+    } else {
+      // Point pointers to the data corresponding to the element
+      for (casadi_int i=0; i<e.arg.size(); ++i)
+        arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : nullptr;
+      for (casadi_int i=0; i<e.res.size(); ++i)
+        res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : nullptr;
+
+      // Evaluate
+      if (e.data->eval(arg1, res1, iw, w1)) return 1;
     }
     return 0;
   }
@@ -1683,7 +1848,7 @@ namespace casadi {
   void MXFunction::serialize_body(SerializingStream &s) const {
     XFunction<MXFunction, MX, MXNode>::serialize_body(s);
 
-    s.version("MXFunction", 1);
+    s.version("MXFunction", 2);
     s.pack("MXFunction::n_instr", algorithm_.size());
 
     // Loop over algorithm
@@ -1697,13 +1862,21 @@ namespace casadi {
     s.pack("MXFunction::free_vars", free_vars_);
     s.pack("MXFunction::default_in", default_in_);
     s.pack("MXFunction::live_variables", live_variables_);
+    s.pack("MXFunction::task_parallel", task_parallel_);
+    s.pack("MXFunction::stage_ptr", stage_ptr_);
+    s.pack("MXFunction::stage_parallel", stage_parallel_);
+    s.pack("MXFunction::n_worker", n_worker_);
+    s.pack("MXFunction::sz_arg_worker", sz_arg_worker_);
+    s.pack("MXFunction::sz_res_worker", sz_res_worker_);
+    s.pack("MXFunction::sz_iw_worker", sz_iw_worker_);
+    s.pack("MXFunction::sz_w_worker", sz_w_worker_);
 
     XFunction<MXFunction, MX, MXNode>::delayed_serialize_members(s);
   }
 
 
   MXFunction::MXFunction(DeserializingStream& s) : XFunction<MXFunction, MX, MXNode>(s) {
-    s.version("MXFunction", 1);
+    s.version("MXFunction", 2);
     size_t n_instructions;
     s.unpack("MXFunction::n_instr", n_instructions);
     algorithm_.resize(n_instructions);
@@ -1719,6 +1892,14 @@ namespace casadi {
     s.unpack("MXFunction::free_vars", free_vars_);
     s.unpack("MXFunction::default_in", default_in_);
     s.unpack("MXFunction::live_variables", live_variables_);
+    s.unpack("MXFunction::task_parallel", task_parallel_);
+    s.unpack("MXFunction::stage_ptr", stage_ptr_);
+    s.unpack("MXFunction::stage_parallel", stage_parallel_);
+    s.unpack("MXFunction::n_worker", n_worker_);
+    s.unpack("MXFunction::sz_arg_worker", sz_arg_worker_);
+    s.unpack("MXFunction::sz_res_worker", sz_res_worker_);
+    s.unpack("MXFunction::sz_iw_worker", sz_iw_worker_);
+    s.unpack("MXFunction::sz_w_worker", sz_w_worker_);
 
     XFunction<MXFunction, MX, MXNode>::delayed_deserialize_members(s);
   }
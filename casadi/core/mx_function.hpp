@@ -80,6 +80,25 @@ namespace casadi {
     /// Live variables?
     bool live_variables_;
 
+    /// Evaluate independent nodes concurrently?
+    bool task_parallel_;
+
+    /** \brief Execution stages for task-parallel evaluation
+
+        Stage s consists of the elements stage_ptr_[s], ..., stage_ptr_[s+1]-1
+        of the algorithm, which is sorted by stage. The elements of a stage with
+        stage_parallel_[s] set are independent and are evaluated concurrently
+        on the shared ThreadPool.
+    */
+    std::vector<casadi_int> stage_ptr_;
+    std::vector<bool> stage_parallel_;
+
+    /// Number of workers with their own scratch space
+    casadi_int n_worker_;
+
+    /// Scratch space of each worker
+    size_t sz_arg_worker_, sz_res_worker_, sz_iw_worker_, sz_w_worker_;
+
     /** \brief Constructor */
     MXFunction(const std::string& name,
       const std::vector<MX>& input, const std::vector<MX>& output,
@@ -92,6 +111,10 @@ namespace casadi {
     /** \brief  Evaluate numerically, work vectors given */
     int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+    /** \brief  Evaluate an element of the algorithm, with scratch space arg1, res1, iw, w1 */
+    int eval_el(const AlgEl& e, const double** arg, double** res, const double** arg1,
+                double** res1, casadi_int* iw, double* w, double* w1) const;
+
     /** \brief  Print description */
     void disp_more(std::ostream& stream) const override;
 
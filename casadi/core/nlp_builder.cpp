@@ -25,7 +25,10 @@
 
 #include "nlp_builder.hpp"
 #include "core.hpp"
-#include <fstream>
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+#include <cstring>
+#include <cstdlib>
 
 using namespace std;
 namespace casadi {
@@ -61,18 +64,26 @@ namespace casadi {
       }
     }
     // Open file for reading
-    s_.open(filename.c_str());
+    file_.reset(new MappedFile(filename));
+    casadi_assert(file_->is_open(), "Could not open file \"" + filename + "\"");
     if (verbose_) casadi_message("Reading file \"" + filename + "\"");
+    pos_ = file_->data();
+    end_ = pos_ + file_->size();
+    chunk_ = tok_ = 0;
 
     // Read the header of the NL-file (first 10 lines)
     const casadi_int header_sz = 10;
     vector<string> header(header_sz);
     for (casadi_int k=0; k<header_sz; ++k) {
-      getline(s_, header[k]);
+      const char* eol = static_cast<const char*>(memchr(pos_, '\n', end_-pos_));
+      casadi_assert(eol!=nullptr, "File could not be read");
+      header[k].assign(pos_, eol);
+      pos_ = eol+1;
     }
 
-    // Assert that the file is not in binary form
-    if (header.at(0).at(0)=='g') {
+    // Text ('g') or binary ('b') format
+    casadi_assert(!header[0].empty(), "File could not be read");
+    if (header[0][0]=='g') {
       binary_ = false;
     } else if (header.at(0).at(0)=='b') {
       binary_ = true;
@@ -160,13 +171,6 @@ namespace casadi {
     // All variables, including dependent
     v_ = nlp_.x;
 
-    if (binary_) {
-      streampos offset = s_.tellg();
-      s_.close();
-      s_.open(filename.c_str(), std::ifstream::binary);
-      s_.seekg(offset);
-    }
-
     // Read segments
     parse();
 
@@ -175,19 +179,16 @@ namespace casadi {
   }
 
   NlImporter::~NlImporter() {
-    // Close the NL file
-    s_.close();
   }
 
   void NlImporter::parse() {
     // Segment key
     char key;
 
-    // Process segments
-    while (true) {
+    // Process segments until the end of the file
+    while (!at_end()) {
       // Read segment key
       key = read_char();
-      if (s_.eof()) break; // end of file encountered
       switch (key) {
         case 'F': F_segment(); break;
         case 'S': S_segment(); break;
@@ -396,7 +397,6 @@ namespace casadi {
       break;
 
       default:
-       uout() << s_.tellg() << std::endl;
       casadi_error("Unknown instruction: " + str(inst));
     }
 
@@ -441,54 +441,172 @@ namespace casadi {
     v_.at(i) += expr();
   }
 
-  int NlImporter::read_int() {
-    int i;
-    if (binary_) {
-      s_.read(reinterpret_cast<char *>(&i), sizeof(int));
-    } else {
-      s_ >> i;
+  namespace {
+    // Read a value from a binary file
+    template<typename T>
+    T read_binary(const char*& pos, const char* end) {
+      casadi_assert(end-pos >= static_cast<std::ptrdiff_t>(sizeof(T)),
+        "Unexpected end of .nl file");
+      T v;
+      memcpy(&v, pos, sizeof(T));
+      pos += sizeof(T);
+      return v;
     }
-    return i;
+  } // namespace
+
+  int NlImporter::read_int() {
+    if (binary_) return read_binary<int>(pos_, end_);
+    const Token& t = next_token();
+    casadi_assert(t.c==0, "Expected a number, got '" + str(t.c) + "'");
+    return static_cast<int>(t.d);
   }
 
   char NlImporter::read_char() {
-    char c;
-    if (binary_) {
-      s_.read(&c, 1);
-    } else {
-      s_ >> c;
-    }
-    return c;
+    if (binary_) return read_binary<char>(pos_, end_);
+    const Token& t = next_token();
+    if (t.c) return t.c;
+    // Single digit, e.g. a bound type
+    casadi_assert(t.d>=0 && t.d<=9 && t.d==static_cast<int>(t.d),
+      "Expected a character, got " + str(t.d));
+    return static_cast<char>('0' + static_cast<int>(t.d));
   }
 
   double NlImporter::read_double() {
-    double d;
-    if (binary_) {
-      s_.read(reinterpret_cast<char *>(&d), sizeof(double));
-    } else {
-      s_ >> d;
-    }
-    return d;
+    if (binary_) return read_binary<double>(pos_, end_);
+    const Token& t = next_token();
+    casadi_assert(t.c==0, "Expected a number, got '" + str(t.c) + "'");
+    return t.d;
   }
 
   short NlImporter::read_short() {
-    short d;
-    if (binary_) {
-      s_.read(reinterpret_cast<char *>(&d), 2);
-    } else {
-      s_ >> d;
-    }
-    return d;
+    if (binary_) return read_binary<short>(pos_, end_);
+    return static_cast<short>(read_double());
   }
 
   long NlImporter::read_long() {
-    long d;
-    if (binary_) {
-      s_.read(reinterpret_cast<char *>(&d), 4);
-    } else {
-      s_ >> d;
+    // Four bytes in binary files
+    if (binary_) return read_binary<int>(pos_, end_);
+    return static_cast<long>(read_double());
+  }
+
+  bool NlImporter::at_end() {
+    if (binary_) return pos_==end_;
+    while (true) {
+      // Skip exhausted chunks
+      while (chunk_<tokens_.size() && tok_==tokens_[chunk_].size()) {
+        chunk_++;
+        tok_ = 0;
+      }
+      if (chunk_<tokens_.size()) return false;
+      if (!next_batch()) return true;
+    }
+  }
+
+  const NlImporter::Token& NlImporter::next_token() {
+    casadi_assert(!at_end(), "Unexpected end of .nl file");
+    return tokens_[chunk_][tok_++];
+  }
+
+  bool NlImporter::next_batch() {
+    if (pos_==end_) return false;
+    // Chunks of about 1 MB of complete lines, a few per worker
+    const std::ptrdiff_t chunk_sz = 1 << 20;
+    casadi_int nw = ThreadPool::instance().size();
+    vector<const char*> split(1, pos_);
+    while (split.size()<=4*nw && split.back()!=end_) {
+      const char* p = split.back();
+      if (end_-p <= chunk_sz) {
+        split.push_back(end_);
+      } else {
+        const char* eol = static_cast<const char*>(memchr(p+chunk_sz, '\n', end_-p-chunk_sz));
+        split.push_back(eol ? eol+1 : end_);
+      }
+    }
+    pos_ = split.back();
+    // Tokenize the chunks in parallel
+    tokens_.resize(split.size()-1);
+    ThreadPool::instance().run(tokens_.size(), nw, [&](casadi_int i, casadi_int w) {
+      tokenize(split[i], split[i+1], tokens_[i]);
+    });
+    chunk_ = tok_ = 0;
+    return true;
+  }
+
+  void NlImporter::tokenize(const char* p, const char* end, std::vector<Token>& tokens) {
+    tokens.clear();
+    while (p<end) {
+      char c = *p;
+      // Skip white space
+      if (c==' ' || c=='\n' || c=='\t' || c=='\r') {
+        p++;
+        continue;
+      }
+      // Skip comments
+      if (c=='#') {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end-p));
+        p = eol ? eol : end;
+        continue;
+      }
+      // Find the end of the token
+      const char* q = p;
+      while (q<end && *q!=' ' && *q!='\n' && *q!='\t' && *q!='\r' && *q!='#') q++;
+      // Leading letter, e.g. a segment key or expression type
+      if ((c>='a' && c<='z') || (c>='A' && c<='Z')) {
+        tokens.push_back({0, c});
+        p++;
+      }
+      // Number, e.g. an index or a value
+      if (p<q) tokens.push_back({parse_number(p, q), 0});
+      p = q;
+    }
+  }
+
+  double NlImporter::parse_number(const char* begin, const char* end) {
+    // Powers of ten that are exactly representable
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+      1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    // Decimal mantissa and exponent
+    const char* p = begin;
+    bool neg = false, fast = true, digits = false;
+    if (p<end && (*p=='-' || *p=='+')) neg = *p++=='-';
+    uint64_t mant = 0;
+    casadi_int exp10 = 0;
+    for (; p<end && *p>='0' && *p<='9'; ++p) {
+      if (mant>=100000000000000000ULL) fast = false;
+      mant = 10*mant + (*p-'0');
+      digits = true;
+    }
+    if (p<end && *p=='.') {
+      for (++p; p<end && *p>='0' && *p<='9'; ++p) {
+        if (mant>=100000000000000000ULL) fast = false;
+        mant = 10*mant + (*p-'0');
+        exp10--;
+        digits = true;
+      }
+    }
+    if (p<end && (*p=='e' || *p=='E')) {
+      bool eneg = false, edigits = false;
+      casadi_int e = 0;
+      ++p;
+      if (p<end && (*p=='-' || *p=='+')) eneg = *p++=='-';
+      for (; p<end && *p>='0' && *p<='9'; ++p) {
+        if (e<10000) e = 10*e + (*p-'0');
+        edigits = true;
+      }
+      if (!edigits) fast = false;
+      exp10 += eneg ? -e : e;
+    }
+    // Exact result for a mantissa and power of ten that are both exactly representable
+    if (fast && digits && p==end && mant < (1ULL << 53) && exp10>=-22 && exp10<=22) {
+      double d = static_cast<double>(mant);
+      d = exp10<0 ? d/pow10[-exp10] : d*pow10[exp10];
+      return neg ? -d : d;
     }
-    return d;
+    // Correctly rounded conversion otherwise
+    string s(begin, end);
+    char* s_end;
+    double d = strtod(s.c_str(), &s_end);
+    return s_end==s.c_str()+s.size() ? d : nan;
   }
 
   void NlImporter::C_segment() {
@@ -27,6 +27,7 @@
 #define CASADI_NLP_BUILDER_HPP
 
 #include "mx.hpp"
+#include <memory>
 
 namespace casadi {
 
@@ -86,8 +87,14 @@ namespace casadi {
   };
 
 #ifndef SWIG
+  class MappedFile;
+
   /** \Helper class for .nl import
   The .nl format is described in "Writing .nl Files" paper by David M. Gay (2005)
+
+  The file is memory-mapped. Binary files are read in place, text files are
+  split into chunks of lines that are tokenized in parallel, a batch of
+  chunks at a time. The expressions are built serially from the tokens.
   \date 2016
   \author Joel Andersson
   */
@@ -103,14 +110,36 @@ namespace casadi {
     double read_double();
     short read_short();
     long read_long();
+    // Has the whole file been read
+    bool at_end();
+    // Token of a text file: a letter, or a number if the letter is zero
+    struct Token {
+      double d;
+      char c;
+    };
+    // Next token of a text file
+    const Token& next_token();
+    // Tokenize the next batch of chunks of a text file
+    bool next_batch();
+    // Tokenize a part of a text file
+    static void tokenize(const char* begin, const char* end, std::vector<Token>& tokens);
+    // Parse a number in a text file
+    static double parse_number(const char* begin, const char* end);
     // Reference to the class
     NlpBuilder& nlp_;
     // Options
     bool verbose_;
     // Binary mode
     bool binary_;
-    // File stream
-    std::ifstream s_;
+    // File contents
+    std::unique_ptr<MappedFile> file_;
+    // Position in the file and end of the file
+    const char* pos_;
+    const char* end_;
+    // Tokens of the current batch, per chunk
+    std::vector<std::vector<Token> > tokens_;
+    // Next token in the current batch
+    size_t chunk_, tok_;
     // All variables, including dependent
     std::vector<MX> v_;
     // Number of objectives and constraints
@@ -14,7 +14,7 @@ void casadi_interpn_weights(casadi_int ndim, const T1* grid, const casadi_int* o
     g = grid + offset[i];
     ng = offset[i+1]-offset[i];
     // Find left index
-    j = index[i] = casadi_low(xi, g, ng, lookup_mode[i]);
+    j = index[i] = casadi_low_table(xi, g, ng, lookup_mode+i);
     // Get interpolation/extrapolation alpha
     alpha[i] = (xi-g[j])/(g[j+1]-g[j]);
   }
@@ -40,6 +40,107 @@ void casadi_ldl(const casadi_int* sp_a, const T1* a,
   }
 }
 
+// SYMBOL "ldl_super"
+// Supernodal variant of casadi_ldl, with the same outputs
+// Column s of sp_super holds the rows of the dense panel of supernode s
+// len[w] >= n + sum_s nrow_s*ncol_s, len[iw] >= 3*n+1
+template<typename T1>
+void casadi_ldl_super(const casadi_int* sp_a, const T1* a,
+                      const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p,
+                      const casadi_int* sp_super, T1* w, casadi_int* iw) {
+  const casadi_int *lt_colind, *lt_row, *a_colind, *a_row, *s_colind, *s_row, *rows;
+  casadi_int n, ns, s, t, f, nc, nr, tnr, c, c1, j, k, m, r;
+  casadi_int *snode, *pos, *off;
+  T1 *x, *pan, *P, *tpan, dk, wjk;
+  // Extract sparsities
+  n=sp_lt[1];
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  ns=sp_super[1];
+  s_colind=sp_super+2; s_row=sp_super+2+ns+1;
+  // Work vectors
+  snode=iw; iw+=n;
+  pos=iw; iw+=n;
+  off=iw; iw+=ns+1;
+  x=w; w+=n;
+  pan=w;
+  // Panel offsets and supernode of each column
+  off[0] = 0;
+  for (s=0; s<ns; ++s) {
+    f = s_row[s_colind[s]];
+    nc = (s+1<ns ? s_row[s_colind[s+1]] : n) - f;
+    nr = s_colind[s+1] - s_colind[s];
+    off[s+1] = off[s] + nc*nr;
+    for (c=f; c<f+nc; ++c) snode[c] = s;
+  }
+  // Clear x
+  for (r=0; r<n; ++r) x[r] = 0;
+  // Sparse copy of the lower triangle of A to the panels
+  for (s=0; s<ns; ++s) {
+    f = s_row[s_colind[s]];
+    nc = (s+1<ns ? s_row[s_colind[s+1]] : n) - f;
+    nr = s_colind[s+1] - s_colind[s];
+    rows = s_row + s_colind[s];
+    P = pan + off[s];
+    for (j=0; j<nc; ++j) {
+      c1 = p[f+j];
+      for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) x[a_row[k]] = a[k];
+      for (m=0; m<nr; ++m) P[j*nr+m] = m<j ? 0 : x[p[rows[m]]];
+      for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) x[a_row[k]] = 0;
+    }
+  }
+  // Loop over supernodes
+  for (s=0; s<ns; ++s) {
+    f = s_row[s_colind[s]];
+    nc = (s+1<ns ? s_row[s_colind[s+1]] : n) - f;
+    nr = s_colind[s+1] - s_colind[s];
+    rows = s_row + s_colind[s];
+    P = pan + off[s];
+    // Dense LDL^T of the panel
+    for (k=0; k<nc; ++k) {
+      dk = P[k*nr+k];
+      d[f+k] = dk;
+      for (m=k+1; m<nr; ++m) P[k*nr+m] /= dk;
+      for (j=k+1; j<nc; ++j) {
+        wjk = P[k*nr+j]*dk;
+        for (m=j; m<nr; ++m) P[j*nr+m] -= P[k*nr+m]*wjk;
+      }
+    }
+    // Update the columns of later supernodes, one column at a time
+    t = -1;
+    for (j=nc; j<nr; ++j) {
+      c = rows[j];
+      if (snode[c]!=t) {
+        // Position of the rows in the panel of the new target supernode
+        t = snode[c];
+        for (m=s_colind[t]; m<s_colind[t+1]; ++m) pos[s_row[m]] = m - s_colind[t];
+      }
+      // Column c of L*D*L^T restricted to the panel
+      for (k=0; k<nc; ++k) {
+        wjk = P[k*nr+j]*d[f+k];
+        for (m=j; m<nr; ++m) x[m] += P[k*nr+m]*wjk;
+      }
+      // Subtract from the target
+      tnr = s_colind[t+1] - s_colind[t];
+      tpan = pan + off[t] + (c - s_row[s_colind[t]])*tnr;
+      for (m=j; m<nr; ++m) {
+        tpan[pos[rows[m]]] -= x[m];
+        x[m] = 0;
+      }
+    }
+  }
+  // Copy to L^T, the rows of each column of L are visited in increasing order
+  for (c=0; c<n; ++c) pos[c] = c - s_row[s_colind[snode[c]]] + 1;
+  for (c=0; c<n; ++c) {
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      r = lt_row[k];
+      s = snode[r];
+      nr = s_colind[s+1] - s_colind[s];
+      lt[k] = pan[off[s] + (r - s_row[s_colind[s]])*nr + pos[r]++];
+    }
+  }
+}
+
 // SYMBOL "ldl_trs"
 // Solve for (I+R) with R an optionally transposed strictly upper triangular matrix.
 template<typename T1>
@@ -66,26 +167,71 @@ void casadi_ldl_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr
   }
 }
 
+// SYMBOL "ldl_trs_blk"
+// Blocked variant of casadi_ldl_trs for nb right-hand-sides, stored interleaved
+// so that x[nb*i+j] is row i of right-hand-side j
+template<typename T1>
+void casadi_ldl_trs_blk(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr,
+                        casadi_int nb) {
+  casadi_int ncol, c, k, j;
+  const casadi_int *colind, *row;
+  T1 rk, *xc, *xr;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x + nb*c;
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        rk = nz_r[k];
+        xr = x + nb*row[k];
+        for (j=0; j<nb; ++j) xc[j] -= rk*xr[j];
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xc = x + nb*c;
+      for (k=colind[c+1]-1; k>=colind[c]; --k) {
+        rk = nz_r[k];
+        xr = x + nb*row[k];
+        for (j=0; j<nb; ++j) xr[j] -= rk*xc[j];
+      }
+    }
+  }
+}
+
 // SYMBOL "ldl_solve"
 // Linear solve using an LDL^T factorized linear system
+// The right-hand-sides are solved for in blocks of up to 8
+// len[w] >= n*min(nrhs, 8)
 template<typename T1>
 void casadi_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1* lt,
                       const T1* d, const casadi_int* p, T1* w) {
-  casadi_int i, k;
+  casadi_int i, j, nb;
   casadi_int n = sp_lt[1];
-  for (k=0; k<nrhs; ++k) {
+  for (; nrhs>0; nrhs-=nb) {
+    // Size of the block
+    nb = nrhs<8 ? nrhs : 8;
     // P' L D L' P x = b <=> x = P' L' \ D \ L \ P b
     // Multiply by P
-    for (i=0; i<n; ++i) w[i] = x[p[i]];
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb; ++j) w[nb*i+j] = x[n*j+p[i]];
+    }
     //  Solve for L
-    casadi_ldl_trs(sp_lt, lt, w, 1);
+    casadi_ldl_trs_blk(sp_lt, lt, w, 1, nb);
     // Divide by D
-    for (i=0; i<n; ++i) w[i] /= d[i];
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb; ++j) w[nb*i+j] /= d[i];
+    }
     // Solve for L'
-    casadi_ldl_trs(sp_lt, lt, w, 0);
+    casadi_ldl_trs_blk(sp_lt, lt, w, 0, nb);
     // Multiply by P'
-    for (i=0; i<n; ++i) x[p[i]] = w[i];
-    // Next rhs
-    x += n;
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb; ++j) x[n*j+p[i]] = w[nb*i+j];
+    }
+    // Next block
+    x += n*nb;
   }
 }
@@ -45,3 +45,57 @@ casadi_int casadi_low(T1 x, const T1* grid, casadi_int ng, casadi_int lookup_mod
       }
   }
 }
+
+// SYMBOL "low_table"
+// casadi_low with lookup_mode pointing to the entry of one grid dimension
+// A negative entry selects a bucket lookup, with the table [nb, b_0, ..., b_{nb-1}]
+// starting at lookup_mode[-lookup_mode[0]]. b_j is the interval containing the start
+// of bucket j, where the buckets divide [grid[0], grid[ng-1]] into nb equal parts
+template<typename T1>
+casadi_int casadi_low_table(T1 x, const T1* grid, casadi_int ng, const casadi_int* lookup_mode) {
+  casadi_int nb, i, j;
+  const casadi_int* b;
+  if (lookup_mode[0]>=0) return casadi_low(x, grid, ng, lookup_mode[0]);
+  b = lookup_mode - lookup_mode[0];
+  nb = b[0];
+  j = (casadi_int) ((x-grid[0])*nb/(grid[ng-1]-grid[0])); // NOLINT(readability/casting)
+  if (j<0) j=0;
+  if (j>nb-1) j=nb-1;
+  i = b[1+j];
+  // Correct for rounding and scan the intervals in the bucket
+  while (i>0 && x<grid[i]) i--;
+  while (i<ng-2 && x>=grid[i+1]) i++;
+  return i;
+}
+
+// SYMBOL "low_hint"
+// casadi_low_table, given the result i for a previous point not larger than x.
+// The intervals following i are tried first
+template<typename T1>
+casadi_int casadi_low_hint(T1 x, const T1* grid, casadi_int ng, const casadi_int* lookup_mode,
+                           casadi_int i) {
+  casadi_int s;
+  if (lookup_mode[0]!=1) {
+    // At most a few steps from the previous interval
+    for (s=0; s<4 && i<ng-2 && x>=grid[i+1]; ++s) i++;
+    if (i>=ng-2 || x<grid[i+1]) return i;
+  }
+  return casadi_low_table(x, grid, ng, lookup_mode);
+}
+
+// SYMBOL "low_batch"
+// casadi_low for n points, reusing the previous result for sorted points
+template<typename T1>
+void casadi_low_batch(T1* ret, const T1* x, casadi_int n, const T1* grid, casadi_int ng,
+                      casadi_int lookup_mode) {
+  casadi_int k, i;
+  i = 0;
+  for (k=0; k<n; ++k) {
+    if (k>0 && x[k]>=x[k-1]) {
+      i = casadi_low_hint(x[k], grid, ng, &lookup_mode, i);
+    } else {
+      i = casadi_low(x[k], grid, ng, lookup_mode);
+    }
+    ret[k] = i;
+  }
+}
@@ -0,0 +1,46 @@
+// NOLINT(legal/copyright)
+// SYMBOL "mtimes_dense"
+// Dense matrix-matrix multiplication, column-major: z <- z + x*y
+// x is nrow_x-by-ncol_x, y is ncol_x-by-ncol_y, z is nrow_x-by-ncol_y
+// Blocked for the cache, four columns of z are updated per pass over a column of x.
+// The entries of z are accumulated in the same order as in casadi_mtimes.
+template<typename T1>
+void casadi_mtimes_dense(const T1* x, casadi_int nrow_x, casadi_int ncol_x,
+    const T1* y, casadi_int ncol_y, T1* z) {
+  casadi_int i, j, k, i0, i1, k0, k1;
+  T1 a, b0, b1, b2, b3;
+  const T1 *xk, *y0, *y1, *y2, *y3;
+  T1 *z0, *z1, *z2, *z3;
+  if (!x || !y || !z) return;
+  // Blocks of 256 columns of x
+  for (k0=0; k0<ncol_x; k0=k1) {
+    k1 = k0+256<ncol_x ? k0+256 : ncol_x;
+    // Blocks of 64 rows of x and z
+    for (i0=0; i0<nrow_x; i0=i1) {
+      i1 = i0+64<nrow_x ? i0+64 : nrow_x;
+      // Four columns of z at a time
+      for (j=0; j+4<=ncol_y; j+=4) {
+        y0 = y + j*ncol_x; y1 = y0 + ncol_x; y2 = y1 + ncol_x; y3 = y2 + ncol_x;
+        z0 = z + j*nrow_x; z1 = z0 + nrow_x; z2 = z1 + nrow_x; z3 = z2 + nrow_x;
+        for (k=k0; k<k1; ++k) {
+          xk = x + k*nrow_x;
+          b0 = y0[k]; b1 = y1[k]; b2 = y2[k]; b3 = y3[k];
+          for (i=i0; i<i1; ++i) {
+            a = xk[i];
+            z0[i] += a*b0; z1[i] += a*b1; z2[i] += a*b2; z3[i] += a*b3;
+          }
+        }
+      }
+      // Remaining columns
+      for (; j<ncol_y; ++j) {
+        y0 = y + j*ncol_x;
+        z0 = z + j*nrow_x;
+        for (k=k0; k<k1; ++k) {
+          xk = x + k*nrow_x;
+          b0 = y0[k];
+          for (i=i0; i<i1; ++i) z0[i] += xk[i]*b0;
+        }
+      }
+    }
+  }
+}
@@ -34,7 +34,7 @@ casadi_int casadi_nd_boor_dual_eval(T1* val, casadi_int* nz, casadi_int n_dims,
     n_b = n_knots-degree-1;
 
     x = all_x[k];
-    L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k]);
+    L = casadi_low_table(x, knots+degree, n_knots-2*degree, lookup_mode+k);
 
     start = L;
     if (start>n_b-degree-1) start = n_b-degree-1;
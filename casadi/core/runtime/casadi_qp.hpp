@@ -24,6 +24,8 @@ struct casadi_qp_prob {
   casadi_int max_iter;
   // Primal and dual error tolerance
   T1 constr_viol_tol, dual_inf_tol;
+  // Maximum number of changed KKT columns before refactorizing
+  casadi_int max_kkt_updates;
 };
 // C-REPLACE "casadi_qp_prob<T1>" "struct casadi_qp_prob"
 
@@ -39,6 +41,7 @@ void casadi_qp_setup(casadi_qp_prob<T1>* p) {
   p->max_iter = 1000;
   p->constr_viol_tol = 1e-8;
   p->dual_inf_tol = 1e-8;
+  p->max_kkt_updates = 20;
 }
 
 // SYMBOL "qp_work"
@@ -75,6 +78,15 @@ void casadi_qp_work(const casadi_qp_prob<T1>* p, casadi_int* sz_iw, casadi_int*
   *sz_iw += p->nz; // lincomb
   *sz_w += casadi_max(nnz_v+nnz_r, nnz_kkt); // [v,r] or trans(kkt)
   *sz_w += p->nz; // beta
+  *sz_w += p->nz*p->max_kkt_updates; // up_z
+  *sz_w += p->max_kkt_updates*p->max_kkt_updates; // up_c
+  *sz_w += p->max_kkt_updates; // up_t
+  *sz_w += p->nz; // up_q
+  *sz_iw += p->nz; // up_active
+  *sz_iw += p->nz; // up_slot
+  *sz_iw += p->max_kkt_updates; // up_ind
+  *sz_iw += p->max_kkt_updates; // up_sign
+  *sz_iw += p->max_kkt_updates; // up_piv
 }
 
 // SYMBOL "qp_flag_t"
@@ -101,6 +113,13 @@ struct casadi_qp_data {
   casadi_int *iw, *neverzero, *neverlower, *neverupper, *lincomb;
   // Numeric QR factorization
   T1 *nz_at, *nz_kkt, *beta, *nz_v, *nz_r;
+  // Number of KKT columns changed since the factorization, -1 if it cannot be updated
+  casadi_int n_up;
+  // Active set at the factorization, slot of each changed column, changed columns,
+  // sign of the changes, pivoting of the Schur complement
+  casadi_int *up_active, *up_slot, *up_ind, *up_sign, *up_piv;
+  // Factorized KKT solved for the changes, LU-factorized Schur complement, work vectors
+  T1 *up_z, *up_c, *up_t, *up_q;
   // Message buffer
   const char *msg;
   // Message index
@@ -123,6 +142,8 @@ struct casadi_qp_data {
   casadi_int r_index, r_sign;
   // Iteration
   casadi_int iter;
+  // Number of KKT factorizations and factorization updates
+  casadi_int n_fact, n_update;
 };
 // C-REPLACE "casadi_qp_data<T1>" "struct casadi_qp_data"
 
@@ -155,6 +176,15 @@ void casadi_qp_init(casadi_qp_data<T1>* d, casadi_int** iw, T1** w) {
   d->neverupper = *iw; *iw += p->nz;
   d->neverlower = *iw; *iw += p->nz;
   d->lincomb = *iw; *iw += p->nz;
+  d->up_z = *w; *w += p->nz*p->max_kkt_updates;
+  d->up_c = *w; *w += p->max_kkt_updates*p->max_kkt_updates;
+  d->up_t = *w; *w += p->max_kkt_updates;
+  d->up_q = *w; *w += p->nz;
+  d->up_active = *iw; *iw += p->nz;
+  d->up_slot = *iw; *iw += p->nz;
+  d->up_ind = *iw; *iw += p->max_kkt_updates;
+  d->up_sign = *iw; *iw += p->max_kkt_updates;
+  d->up_piv = *iw; *iw += p->max_kkt_updates;
   d->w = *w;
   d->iw = *iw;
 }
@@ -198,6 +228,9 @@ int casadi_qp_reset(casadi_qp_data<T1>* d) {
   d->r_sign = 0;
   // Reset iteration counter
   d->iter = 0;
+  // No factorization yet
+  d->n_up = -1;
+  d->n_fact = d->n_update = 0;
   return 0;
 }
 
@@ -447,6 +480,181 @@ void casadi_qp_kkt_residual(casadi_qp_data<T1>* d, T1* r) {
   }
 }
 
+// SYMBOL "qp_update_reset"
+// Store the active set of a new factorization of the KKT matrix
+template<typename T1>
+void casadi_qp_update_reset(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // A singular factorization cannot be updated
+  d->n_up = d->sing ? -1 : 0;
+  for (i=0; i<p->nz; ++i) {
+    d->up_active[i] = d->lam[i]!=0.;
+    d->up_slot[i] = -1;
+  }
+}
+
+// SYMBOL "qp_update"
+// Update the factorization of the KKT matrix after active-set changes.
+// With K0 the factorized matrix, the changed matrix is K0 + U*E', where
+// the columns of E are unit vectors for the changed columns of K0.
+// K0\U and the LU factorization of the Schur complement I + E'*(K0\U) are kept.
+// Returns 1 if the matrix needs to be refactorized.
+template<typename T1>
+int casadi_qp_update(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int i, j, k, s, r, sgn;
+  T1 t, cmin, cmax;
+  T1 *z, *c;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Is there a factorization that can be updated?
+  if (d->n_up < 0) return 1;
+  // Update the changed columns
+  for (i=0; i<p->nz; ++i) {
+    // Change of column i compared to the factorization
+    k = d->lam[i]!=0.;
+    sgn = k==d->up_active[i] ? 0 : k ? -1 : 1;
+    s = d->up_slot[i];
+    if (s<0) {
+      // Skip if unchanged
+      if (sgn==0) continue;
+      // Refactorize if too many changes
+      if (d->n_up==p->max_kkt_updates) return 1;
+      // New changed column
+      s = d->up_slot[i] = d->n_up++;
+      d->up_ind[s] = i;
+      d->up_sign[s] = 0;
+    }
+    // Skip if no further change
+    if (sgn==d->up_sign[s]) continue;
+    d->up_sign[s] = sgn;
+    // Solve K0 z = change in column i
+    z = d->up_z + s*p->nz;
+    if (sgn==0) {
+      casadi_clear(z, p->nz);
+    } else {
+      casadi_qp_kkt_vector(d, z, i);
+      if (sgn<0) casadi_scal(p->nz, -1., z);
+      casadi_qr_solve(z, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                      p->prinv, p->pc, d->w);
+    }
+  }
+  // Form the Schur complement
+  r = d->n_up;
+  c = d->up_c;
+  for (s=0; s<r; ++s) {
+    z = d->up_z + s*p->nz;
+    for (j=0; j<r; ++j) c[j+s*r] = z[d->up_ind[j]];
+    c[s+s*r] += 1.;
+  }
+  // LU factorization with partial pivoting
+  cmin = p->inf;
+  cmax = 0.;
+  for (k=0; k<r; ++k) {
+    // Find the pivot and swap rows
+    d->up_piv[k] = k;
+    for (j=k+1; j<r; ++j) {
+      if (fabs(c[j+k*r]) > fabs(c[d->up_piv[k]+k*r])) d->up_piv[k] = j;
+    }
+    j = d->up_piv[k];
+    if (j!=k) {
+      for (s=0; s<r; ++s) {
+        t = c[k+s*r];
+        c[k+s*r] = c[j+s*r];
+        c[j+s*r] = t;
+      }
+    }
+    // Refactorize if (close to) singular
+    t = fabs(c[k+k*r]);
+    cmin = fmin(cmin, t);
+    cmax = fmax(cmax, t);
+    if (cmin < 1e-4 || cmin < 1e-8*cmax) return 1;
+    // Eliminate below the diagonal
+    for (j=k+1; j<r; ++j) {
+      c[j+k*r] /= c[k+k*r];
+      for (s=k+1; s<r; ++s) c[j+s*r] -= c[j+k*r]*c[k+s*r];
+    }
+  }
+  // Nonsingular
+  d->sing = 0;
+  return 0;
+}
+
+// SYMBOL "qp_update_solve"
+// Solve a linear system with the Schur complement of the updated KKT matrix
+template<typename T1>
+void casadi_qp_update_solve(casadi_qp_data<T1>* d, T1* x, casadi_int tr) {
+  // Local variables
+  casadi_int j, k, r;
+  T1 t;
+  const T1* c;
+  r = d->n_up;
+  c = d->up_c;
+  if (tr) {
+    // Solve with U' and L'
+    for (k=0; k<r; ++k) {
+      for (j=0; j<k; ++j) x[k] -= c[j+k*r]*x[j];
+      x[k] /= c[k+k*r];
+    }
+    for (k=r-1; k>=0; --k) {
+      for (j=k+1; j<r; ++j) x[k] -= c[j+k*r]*x[j];
+    }
+    // Undo the row swaps
+    for (k=r-1; k>=0; --k) {
+      j = d->up_piv[k];
+      t = x[k]; x[k] = x[j]; x[j] = t;
+    }
+  } else {
+    // Row swaps
+    for (k=0; k<r; ++k) {
+      j = d->up_piv[k];
+      t = x[k]; x[k] = x[j]; x[j] = t;
+    }
+    // Solve with L and U
+    for (k=0; k<r; ++k) {
+      for (j=k+1; j<r; ++j) x[j] -= c[j+k*r]*x[k];
+    }
+    for (k=r-1; k>=0; --k) {
+      x[k] /= c[k+k*r];
+      for (j=0; j<k; ++j) x[j] -= c[j+k*r]*x[k];
+    }
+  }
+}
+
+// SYMBOL "qp_solve"
+// Solve a linear system with the KKT matrix, or its transpose if tr
+template<typename T1>
+void casadi_qp_solve(casadi_qp_data<T1>* d, T1* x, casadi_int tr) {
+  // Local variables
+  casadi_int j, r;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Solve with the factorized matrix K0
+  casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                  p->prinv, p->pc, d->w);
+  // Correct for the changed columns
+  r = d->n_up;
+  if (r <= 0) return;
+  if (tr) {
+    // (K0' + E*U') \ b = K0' \ (b - E*(S' \ (U'*(K0' \ b))))
+    for (j=0; j<r; ++j) {
+      d->up_t[j] = d->up_sign[j]==0 ? 0.
+        : -d->up_sign[j]*casadi_qp_kkt_dot(d, x, d->up_ind[j]);
+    }
+    casadi_qp_update_solve(d, d->up_t, 1);
+    casadi_clear(d->up_q, p->nz);
+    for (j=0; j<r; ++j) d->up_q[d->up_ind[j]] = d->up_t[j];
+    casadi_qr_solve(d->up_q, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+                    p->prinv, p->pc, d->w);
+    casadi_axpy(p->nz, -1., d->up_q, x);
+  } else {
+    // (K0 + U*E') \ b = K0 \ b - (K0 \ U)*(S \ (E'*(K0 \ b)))
+    for (j=0; j<r; ++j) d->up_t[j] = x[d->up_ind[j]];
+    casadi_qp_update_solve(d, d->up_t, 0);
+    for (j=0; j<r; ++j) casadi_axpy(p->nz, -d->up_t[j], d->up_z + j*p->nz, x);
+  }
+}
+
 // SYMBOL "qp_zero_blocking"
 template<typename T1>
 int casadi_qp_zero_blocking(casadi_qp_data<T1>* d) {
@@ -649,6 +857,32 @@ void casadi_qp_take_step(casadi_qp_data<T1>* d) {
   }
 }
 
+// SYMBOL "qp_factorize"
+template<typename T1>
+void casadi_qp_factorize(casadi_qp_data<T1>* d) {
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Do we already have a search direction due to lost singularity?
+  if (d->has_search_dir) {
+    d->sing = 1;
+    return;
+  }
+  // Update the factorization, if possible
+  if (!casadi_qp_update(d)) {
+    if (d->n_up > 0) d->n_update++;
+    return;
+  }
+  d->n_fact++;
+  // Construct the KKT matrix
+  casadi_qp_kkt(d);
+  // QR factorization
+  casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
+            d->nz_r, d->beta, p->prinv, p->pc);
+  // Check singularity
+  d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
+  // Active set of the factorization
+  casadi_qp_update_reset(d);
+}
+
 // SYMBOL "qp_flip_check"
 template<typename T1>
 int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
@@ -658,15 +892,22 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   // Calculate the difference between old and new column index
   if (d->sign == 0) casadi_scal(p->nz, -1., d->dlam);
   // Try to find a linear combination of the new columns
-  casadi_qr_solve(d->dlam, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dlam, 0);
+  // Refactorize and repeat if the updated factorization is not accurate enough
+  if (d->n_up > 0 && fabs(d->dlam[d->index]-1.) < 1e-6) {
+    d->n_up = -1;
+    casadi_qp_factorize(d);
+    if (d->sing) return 0;
+    casadi_qp_kkt_vector(d, d->dlam, d->index);
+    if (d->sign == 0) casadi_scal(p->nz, -1., d->dlam);
+    casadi_qp_solve(d, d->dlam, 0);
+  }
   // If dlam[index]!=1, new columns must be linearly independent
   if (fabs(d->dlam[d->index]-1.) >= 1e-12) return 0;
   // Next, find a linear combination of the new rows
   casadi_clear(d->dz, p->nz);
   d->dz[d->index] = 1;
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dz, 1);
   // Normalize dlam, dz
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dlam, d->dlam)), d->dlam);
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dz, d->dz)), d->dz);
@@ -674,24 +915,6 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   return 1;
 }
 
-// SYMBOL "qp_factorize"
-template<typename T1>
-void casadi_qp_factorize(casadi_qp_data<T1>* d) {
-  const casadi_qp_prob<T1>* p = d->prob;
-  // Do we already have a search direction due to lost singularity?
-  if (d->has_search_dir) {
-    d->sing = 1;
-    return;
-  }
-  // Construct the KKT matrix
-  casadi_qp_kkt(d);
-  // QR factorization
-  casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
-            d->nz_r, d->beta, p->prinv, p->pc);
-  // Check singularity
-  d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
-}
-
 // SYMBOL "qp_expand_step"
 template<typename T1>
 void casadi_qp_expand_step(casadi_qp_data<T1>* d) {
@@ -807,6 +1030,8 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
     casadi_copy(d->nz_v, nnz_kkt, d->nz_kkt);
     casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r, d->nz_r,
               d->beta, p->prinv, p->pc);
+    // The factorization of the KKT matrix is lost
+    d->n_up = -1;
     // For all nullspace vectors
     nk = casadi_qr_singular(static_cast<T1*>(0), 0, d->nz_r, p->sp_r, p->pc, 1e-12);
   }
@@ -904,8 +1129,6 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
 // SYMBOL "qp_calc_step"
 template<typename T1>
 int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
-  // Local variables
-  const casadi_qp_prob<T1>* p = d->prob;
   // Reset returns
   d->r_index = -1;
   d->r_sign = 0;
@@ -914,8 +1137,7 @@ int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
   // Negative KKT residual
   casadi_qp_kkt_residual(d, d->dz);
   // Solve to get step in z[:nx] and lam[nx:]
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-                  p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dz, 1);
   // Have step in dz[:nx] and dlam[nx:]. Calculate complete dz and dlam
   casadi_qp_expand_step(d);
   // Successful return
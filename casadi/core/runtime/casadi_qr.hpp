@@ -142,39 +142,130 @@ void casadi_qr_trs(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr)
   }
 }
 
+// SYMBOL "qr_mv_blk"
+// Blocked variant of casadi_qr_mv for nb <= 8 right-hand-sides, stored interleaved
+// so that x[nb*i+j] is row i of right-hand-side j
+template<typename T1>
+void casadi_qr_mv_blk(const casadi_int* sp_v, const T1* v, const T1* beta, T1* x,
+                      casadi_int tr, casadi_int nb) {
+  // Local variables
+  casadi_int ncol, c, c1, k, j;
+  T1 alpha[8], vk, *xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_v[1];
+  colind=sp_v+2; row=sp_v+2+ncol+1;
+  // Loop over vectors
+  for (c1=0; c1<ncol; ++c1) {
+    // Forward order for transpose, otherwise backwards
+    c = tr ? c1 : ncol-1-c1;
+    // Calculate scalar factors alpha = beta(c)*dot(v(:,c), x)
+    for (j=0; j<nb; ++j) alpha[j] = 0;
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      vk = v[k];
+      xr = x + nb*row[k];
+      for (j=0; j<nb; ++j) alpha[j] += vk*xr[j];
+    }
+    for (j=0; j<nb; ++j) alpha[j] *= beta[c];
+    // x -= alpha*v(:,c)
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      vk = v[k];
+      xr = x + nb*row[k];
+      for (j=0; j<nb; ++j) xr[j] -= alpha[j]*vk;
+    }
+  }
+}
+
+// SYMBOL "qr_trs_blk"
+// Blocked variant of casadi_qr_trs for nb right-hand-sides, stored interleaved
+template<typename T1>
+void casadi_qr_trs_blk(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int tr,
+                       casadi_int nb) {
+  // Local variables
+  casadi_int ncol, r, c, k, j;
+  T1 rk, *xc, *xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x + nb*c;
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        r = row[k];
+        rk = nz_r[k];
+        if (r==c) {
+          for (j=0; j<nb; ++j) xc[j] /= rk;
+        } else {
+          xr = x + nb*r;
+          for (j=0; j<nb; ++j) xc[j] -= rk*xr[j];
+        }
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xc = x + nb*c;
+      for (k=colind[c+1]-1; k>=colind[c]; --k) {
+        r = row[k];
+        rk = nz_r[k];
+        if (r==c) {
+          for (j=0; j<nb; ++j) xc[j] /= rk;
+        } else {
+          xr = x + nb*r;
+          for (j=0; j<nb; ++j) xr[j] -= rk*xc[j];
+        }
+      }
+    }
+  }
+}
+
 // SYMBOL "qr_solve"
 // Solve a factorized linear system
-// len[w] >= max(ncol, nrow_ext)
+// The right-hand-sides are solved for in blocks of up to 8
+// len[w] >= max(ncol, nrow_ext)*min(nrhs, 8)
 template<typename T1>
 void casadi_qr_solve(T1* x, casadi_int nrhs, casadi_int tr,
                      const casadi_int* sp_v, const T1* v, const casadi_int* sp_r, const T1* r,
                      const T1* beta, const casadi_int* prinv, const casadi_int* pc, T1* w) {
-  casadi_int k, c, nrow_ext, ncol;
+  casadi_int j, c, nb, nrow_ext, ncol;
   nrow_ext = sp_v[0]; ncol = sp_v[1];
-  for (k=0; k<nrhs; ++k) {
+  for (; nrhs>0; nrhs-=nb) {
+    // Size of the block
+    nb = nrhs<8 ? nrhs : 8;
     if (tr) {
       // (PR' Q R PC)' x = PC' R' Q' PR x = b <-> x = PR' Q R' \ PC b
       // Multiply by PC
-      for (c=0; c<ncol; ++c) w[c] = x[pc[c]];
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb; ++j) w[nb*c+j] = x[ncol*j+pc[c]];
+      }
       //  Solve for R'
-      casadi_qr_trs(sp_r, r, w, 1);
+      casadi_qr_trs_blk(sp_r, r, w, 1, nb);
       // Multiply by Q
-      casadi_qr_mv(sp_v, v, beta, w, 0);
+      casadi_qr_mv_blk(sp_v, v, beta, w, 0, nb);
       // Multiply by PR'
-      for (c=0; c<ncol; ++c) x[c] = w[prinv[c]];
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb; ++j) x[ncol*j+c] = w[nb*prinv[c]+j];
+      }
     } else {
       //PR' Q R PC x = b <-> x = PC' R \ Q' PR b
       // Multiply with PR
-      for (c=0; c<nrow_ext; ++c) w[c] = 0;
-      for (c=0; c<ncol; ++c) w[prinv[c]] = x[c];
+      for (c=0; c<nb*nrow_ext; ++c) w[c] = 0;
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb; ++j) w[nb*prinv[c]+j] = x[ncol*j+c];
+      }
       // Multiply with Q'
-      casadi_qr_mv(sp_v, v, beta, w, 1);
+      casadi_qr_mv_blk(sp_v, v, beta, w, 1, nb);
       //  Solve for R
-      casadi_qr_trs(sp_r, r, w, 0);
+      casadi_qr_trs_blk(sp_r, r, w, 0, nb);
       // Multiply with PC'
-      for (c=0; c<ncol; ++c) x[pc[c]] = w[c];
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb; ++j) x[ncol*j+pc[c]] = w[nb*c+j];
+      }
     }
-    x += ncol;
+    // Next block
+    x += ncol*nb;
   }
 }
 
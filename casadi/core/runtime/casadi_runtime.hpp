@@ -90,6 +90,11 @@ namespace casadi {
   void casadi_mtimes(const T1* x, const casadi_int* sp_x, const T1* y, const casadi_int* sp_y,
                              T1* z, const casadi_int* sp_z, T1* w, casadi_int tr);
 
+  /// Dense matrix-matrix multiplication: z <- z + x*y
+  template<typename T1>
+  void casadi_mtimes_dense(const T1* x, casadi_int nrow_x, casadi_int ncol_x,
+                           const T1* y, casadi_int ncol_y, T1* z);
+
   /// Sparse matrix-vector multiplication: z <- z + x*y
   template<typename T1>
   void casadi_mv(const T1* x, const casadi_int* sp_x, const T1* y, T1* z, casadi_int tr);
@@ -150,6 +155,20 @@ namespace casadi {
   template<typename T1>
   casadi_int casadi_low(T1 x, const T1* grid, casadi_int ng, casadi_int lookup_mode);
 
+  // Find the interval to which a value belongs, bucket tables allowed
+  template<typename T1>
+  casadi_int casadi_low_table(T1 x, const T1* grid, casadi_int ng, const casadi_int* lookup_mode);
+
+  // Find the interval to which a value belongs, starting from the interval of a smaller value
+  template<typename T1>
+  casadi_int casadi_low_hint(T1 x, const T1* grid, casadi_int ng, const casadi_int* lookup_mode,
+                             casadi_int i);
+
+  // Find the intervals for a vector of values, reusing the previous interval if sorted
+  template<typename T1>
+  void casadi_low_batch(T1* ret, const T1* x, casadi_int n, const T1* grid, casadi_int ng,
+                        casadi_int lookup_mode);
+
   // Get weights for the multilinear interpolant
   template<typename T1>
   void casadi_interpn_weights(casadi_int ndim, const T1* grid, const casadi_int* offset,
@@ -182,6 +201,14 @@ namespace casadi {
                             casadi_int m,
                             const T1* x, const casadi_int* lookup_mode, casadi_int* iw, T1* w);
 
+  // De boor nd evaluation for multiple points
+  template<typename T1>
+  void casadi_nd_boor_eval_batch(T1* ret, casadi_int n_dims, const T1* knots,
+                            const casadi_int* offset, const casadi_int* degree,
+                            const casadi_int* strides, const T1* c, casadi_int m,
+                            const T1* x, casadi_int n, const casadi_int* lookup_mode,
+                            casadi_int* iw, T1* w);
+
   template<typename T1>
   T1 casadi_mmax(const T1* x, casadi_int n, T1 is_dense);
 
@@ -243,6 +270,7 @@ namespace casadi {
   #include "casadi_vfmax.hpp"
   #include "casadi_sum_viol.hpp"
   #include "casadi_mtimes.hpp"
+  #include "casadi_mtimes_dense.hpp"
   #include "casadi_mv.hpp"
   #include "casadi_trans.hpp"
   #include "casadi_norm_1.hpp"
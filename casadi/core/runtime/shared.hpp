@@ -26,11 +26,117 @@
 #include "../casadi_misc.hpp"
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #ifndef CASADI_CASADI_SHARED_HPP
 #define CASADI_CASADI_SHARED_HPP
 
 namespace casadi {
+  /** \brief Plan the loops of an Einstein contraction
+
+      The iteration dimensions are ordered from the outermost loop to the innermost
+      loop by decreasing stride, so that the inner loops run through memory
+      contiguously. Dimensions that are contiguous in all three tensors are merged.
+      The outermost loop is chosen to write to distinct entries of C where possible,
+      such that it can be distributed over threads.
+  */
+  inline void einstein_plan(std::vector<casadi_int>& iter_dims,
+      std::vector<casadi_int>& strides_a, std::vector<casadi_int>& strides_b,
+      std::vector<casadi_int>& strides_c) {
+    casadi_int n = iter_dims.size();
+    // Nothing to do for an empty contraction
+    for (casadi_int d : iter_dims) if (d==0) return;
+    // Dimensions with more than one element, ordered by decreasing stride
+    std::vector<casadi_int> cost(n), order;
+    for (casadi_int j=0; j<n; ++j) {
+      cost[j] = strides_a[1+j] + strides_b[1+j] + 2*strides_c[1+j];
+      if (iter_dims[j]>1) order.push_back(j);
+    }
+    std::stable_sort(order.begin(), order.end(),
+      [&](casadi_int i, casadi_int j) { return cost[i]>cost[j];});
+    // Merge dimensions that are contiguous in all tensors
+    std::vector<casadi_int> dims, sa(1, strides_a[0]), sb(1, strides_b[0]), sc(1, strides_c[0]);
+    for (casadi_int j : order) {
+      if (!dims.empty() && sa.back()==strides_a[1+j]*iter_dims[j]
+          && sb.back()==strides_b[1+j]*iter_dims[j]
+          && sc.back()==strides_c[1+j]*iter_dims[j]) {
+        dims.back()*= iter_dims[j];
+        sa.back() = strides_a[1+j];
+        sb.back() = strides_b[1+j];
+        sc.back() = strides_c[1+j];
+      } else {
+        dims.push_back(iter_dims[j]);
+        sa.push_back(strides_a[1+j]);
+        sb.push_back(strides_b[1+j]);
+        sc.push_back(strides_c[1+j]);
+      }
+    }
+    // Move the outermost loop that writes to distinct entries of C to the front,
+    // unless it is one of the two innermost loops
+    n = dims.size();
+    for (casadi_int j=0; j+2<n; ++j) {
+      if (sc[1+j]==0) continue;
+      std::rotate(dims.begin(), dims.begin()+j, dims.begin()+j+1);
+      std::rotate(sa.begin()+1, sa.begin()+1+j, sa.begin()+2+j);
+      std::rotate(sb.begin()+1, sb.begin()+1+j, sb.begin()+2+j);
+      std::rotate(sc.begin()+1, sc.begin()+1+j, sc.begin()+2+j);
+      break;
+    }
+    iter_dims = dims;
+    strides_a = sa;
+    strides_b = sb;
+    strides_c = sc;
+  }
+
+  /** \brief Detect a dense matrix product in the innermost loops of a planned contraction
+
+      Returns the number of innermost loops that together form a column-major
+      product z += x*y, with x m-by-k, y k-by-n, or 0 if there is none.
+      On success, gemm = {m, k, n, swap}, where swap indicates that x is B and y is A.
+  */
+  inline casadi_int einstein_gemm(const std::vector<casadi_int>& iter_dims,
+      const std::vector<casadi_int>& strides_a, const std::vector<casadi_int>& strides_b,
+      const std::vector<casadi_int>& strides_c, casadi_int* gemm) {
+    casadi_int n = iter_dims.size();
+    for (casadi_int swap=0; swap<2; ++swap) {
+      const std::vector<casadi_int>& sx = swap ? strides_b : strides_a;
+      const std::vector<casadi_int>& sy = swap ? strides_a : strides_b;
+      for (casadi_int n_gemm=std::min(n, static_cast<casadi_int>(3)); n_gemm>=2; --n_gemm) {
+        // Classify the loops: 0 for rows, 1 for the summation, 2 for columns
+        casadi_int loop[3] = {-1, -1, -1};
+        bool ok = true;
+        for (casadi_int j=n-n_gemm; j<n && ok; ++j) {
+          casadi_int t;
+          if (sx[1+j] && !sy[1+j] && strides_c[1+j]) {
+            t = 0;
+          } else if (sx[1+j] && sy[1+j] && !strides_c[1+j]) {
+            t = 1;
+          } else if (!sx[1+j] && sy[1+j] && strides_c[1+j]) {
+            t = 2;
+          } else {
+            ok = false;
+            break;
+          }
+          if (loop[t]>=0) ok = false;
+          loop[t] = j;
+        }
+        if (!ok) continue;
+        casadi_int m = loop[0]<0 ? 1 : iter_dims[loop[0]];
+        casadi_int k = loop[1]<0 ? 1 : iter_dims[loop[1]];
+        // Column-major storage without gaps
+        if (loop[0]>=0 && (sx[1+loop[0]]!=1 || strides_c[1+loop[0]]!=1)) continue;
+        if (loop[1]>=0 && (sx[1+loop[1]]!=m || sy[1+loop[1]]!=1)) continue;
+        if (loop[2]>=0 && (sy[1+loop[2]]!=k || strides_c[1+loop[2]]!=m)) continue;
+        gemm[0] = m;
+        gemm[1] = k;
+        gemm[2] = loop[2]<0 ? 1 : iter_dims[loop[2]];
+        gemm[3] = swap;
+        return n_gemm;
+      }
+    }
+    return 0;
+  }
+
 template<typename T>
 casadi_int einstein_process(const T& A, const T& B, const T& C,
   const std::vector<casadi_int>& dim_a, const std::vector<casadi_int>& dim_b, const std::vector<casadi_int>& dim_c,
@@ -144,6 +250,8 @@ casadi_int einstein_process(const T& A, const T& B, const T& C,
       cumprod*= dim_c[j];
     }
 
+    einstein_plan(iter_dims, strides_a, strides_b, strides_c);
+
     return n_iter;
   }
 
@@ -157,105 +265,155 @@ casadi_int einstein_process(const T& A, const T& B, const T& C,
     r|= a | b;
   }
 
-  template<typename T>
-  void einstein_eval(casadi_int n_iter,
-      const std::vector<casadi_int>& iter_dims,
-      const std::vector<casadi_int>& strides_a, const std::vector<casadi_int>& strides_b, const std::vector<casadi_int>& strides_c,
-      const T* a_in, const T* b_in, T* c_in) {
+  /** \brief Evaluate an Einstein contraction
 
-    if (!n_iter) return;
-
-    casadi_int iter_dim1 = 1, iter_dim2 = 1, iter_dim3 = 1;
-
-    casadi_int n = iter_dims.size();
-
-    casadi_int stridea1=0, strideb1=0, stridec1=0;
-    casadi_int stridea2=0, strideb2=0, stridec2=0;
-    casadi_int stridea3=0, strideb3=0, stridec3=0;
-    if (n>0) {
-      iter_dim3 = iter_dims[n-1];
-      stridea3 = strides_a[n];
-      strideb3 = strides_b[n];
-      stridec3 = strides_c[n];
+      The iteration dimensions are looped over in the order given, the first
+      one outermost. If n_gemm>0, the innermost n_gemm dimensions are replaced
+      by a dense matrix product with dimensions gemm = {m, k, n, swap}.
+  */
+  template<typename T>
+  void einstein_loop(casadi_int d, casadi_int n, const casadi_int* dims,
+      const casadi_int* strides_a, const casadi_int* strides_b, const casadi_int* strides_c,
+      casadi_int n_gemm, const casadi_int* gemm, const T* a, const T* b, T* c) {
+    casadi_int i, i2, n1, n2, sa1, sb1, sc1, sa2, sb2, sc2;
+    const T *a2, *b2;
+    T* c2;
+    if (n_gemm>0 && d==n-n_gemm) {
+      if (gemm[3]) std::swap(a, b);
+      casadi_mtimes_dense(a, gemm[0], gemm[1], b, gemm[2], c);
+      return;
     }
-    if (n>1) {
-      iter_dim2 = iter_dims[n-2];
-      stridea2 = strides_a[n-1];
-      strideb2 = strides_b[n-1];
-      stridec2 = strides_c[n-1];
+    if (d==n) {
+      Contraction<T>(*a, *b, *c);
+      return;
     }
-    if (n>2) {
-      iter_dim1 = iter_dims[n-3];
-      stridea1 = strides_a[n-2];
-      strideb1 = strides_b[n-2];
-      stridec1 = strides_c[n-2];
+    if (d+2<n) {
+      for (i=0; i<dims[d]; ++i) {
+        einstein_loop(d+1, n, dims, strides_a, strides_b, strides_c, n_gemm, gemm, a, b, c);
+        a+= strides_a[d];
+        b+= strides_b[d];
+        c+= strides_c[d];
+      }
+      return;
     }
-
-
-    const casadi_int* ptr_iter_dims = get_ptr(iter_dims);
-
-    const casadi_int *ptr_strides_a = get_ptr(strides_a)+1;
-    const casadi_int *ptr_strides_b = get_ptr(strides_b)+1;
-    const casadi_int *ptr_strides_c = get_ptr(strides_c)+1;
-
-    // Data pointers
-    const T* a_perm = a_in+strides_a[0];
-    const T* b_perm = b_in+strides_b[0];
-    T* c_perm = c_in+strides_c[0];
-
-    n_iter/= iter_dim1*iter_dim2*iter_dim3;
-
-    // Main loop
-    for (casadi_int i=0;i<n_iter;++i) {
-
-      // Data pointers
-      const T* a = a_perm;
-      const T* b = b_perm;
-      T* c = c_perm;
-
-      // Construct indices
-      casadi_int sub = i;
-      for (casadi_int j=0;j<n-3;++j) {
-        casadi_int ind = sub % ptr_iter_dims[j];
-        a+= ptr_strides_a[j]*ind;
-        b+= ptr_strides_b[j]*ind;
-        c+= ptr_strides_c[j]*ind;
-        sub/= ptr_iter_dims[j];
+    // Innermost one or two loops
+    if (d+1==n) {
+      n1 = 1;
+      sa1 = sb1 = sc1 = 0;
+    } else {
+      n1 = dims[d];
+      sa1 = strides_a[d];
+      sb1 = strides_b[d];
+      sc1 = strides_c[d];
+      d++;
+    }
+    n2 = dims[d];
+    sa2 = strides_a[d];
+    sb2 = strides_b[d];
+    sc2 = strides_c[d];
+    i = 0;
+    if (sc2==0 && sc1!=0) {
+      // Summation, four independent sums at a time
+      T r0, r1, r2, r3;
+      for (; i+4<=n1; i+=4) {
+        a2 = a;
+        b2 = b;
+        r0 = c[0];
+        r1 = c[sc1];
+        r2 = c[2*sc1];
+        r3 = c[3*sc1];
+        for (i2=0; i2<n2; ++i2) {
+          Contraction<T>(a2[0], b2[0], r0);
+          Contraction<T>(a2[sa1], b2[sb1], r1);
+          Contraction<T>(a2[2*sa1], b2[2*sb1], r2);
+          Contraction<T>(a2[3*sa1], b2[3*sb1], r3);
+          a2+= sa2;
+          b2+= sb2;
+        }
+        c[0] = r0;
+        c[sc1] = r1;
+        c[2*sc1] = r2;
+        c[3*sc1] = r3;
+        a+= 4*sa1;
+        b+= 4*sb1;
+        c+= 4*sc1;
       }
-
-      const T* a1 = a;
-      const T* b1 = b;
-      T* c1 = c;
-      for (casadi_int i1=0;i1<iter_dim1;++i1) {
-        const T* a2 = a1;
-        const T* b2 = b1;
-        T* c2 = c1;
-        for (casadi_int i2=0;i2<iter_dim2;++i2) {
-          const T* a3 = a2;
-          const T* b3 = b2;
-          T* c3 = c2;
-          for (casadi_int i3=0;i3<iter_dim3;++i3) {
-            // Perform the actual multiplication
-            Contraction<T>(*a3, *b3, *c3);
-
-            a3+= stridea3;
-            b3+= strideb3;
-            c3+= stridec3;
+    }
+    for (; i<n1; ++i) {
+      a2 = a;
+      b2 = b;
+      c2 = c;
+      if (sc2==0) {
+        // Summation, accumulate in a local variable
+        T r = *c2;
+        for (i2=0; i2<n2; ++i2) {
+          Contraction<T>(*a2, *b2, r);
+          a2+= sa2;
+          b2+= sb2;
+        }
+        *c2 = r;
+      } else if (sb2==0) {
+        // Factor from B is constant
+        const T bv = *b2;
+        if (sa2==1 && sc2==1) {
+          for (i2=0; i2<n2; ++i2) Contraction<T>(a2[i2], bv, c2[i2]);
+        } else {
+          for (i2=0; i2<n2; ++i2) {
+            Contraction<T>(*a2, bv, *c2);
+            a2+= sa2;
+            c2+= sc2;
           }
-          a2+= stridea2;
-          b2+= strideb2;
-          c2+= stridec2;
         }
-        a1+= stridea1;
-        b1+= strideb1;
-        c1+= stridec1;
+      } else if (sa2==0) {
+        // Factor from A is constant
+        const T av = *a2;
+        if (sb2==1 && sc2==1) {
+          for (i2=0; i2<n2; ++i2) Contraction<T>(av, b2[i2], c2[i2]);
+        } else {
+          for (i2=0; i2<n2; ++i2) {
+            Contraction<T>(av, *b2, *c2);
+            b2+= sb2;
+            c2+= sc2;
+          }
+        }
+      } else {
+        for (i2=0; i2<n2; ++i2) {
+          Contraction<T>(*a2, *b2, *c2);
+          a2+= sa2;
+          b2+= sb2;
+          c2+= sc2;
+        }
       }
+      a+= sa1;
+      b+= sb1;
+      c+= sc1;
+    }
+  }
 
+  template<typename T>
+  void einstein_eval(casadi_int n_iter,
+      const std::vector<casadi_int>& iter_dims,
+      const std::vector<casadi_int>& strides_a, const std::vector<casadi_int>& strides_b, const std::vector<casadi_int>& strides_c,
+      const T* a_in, const T* b_in, T* c_in) {
 
-    }
+    if (!n_iter) return;
 
+    einstein_loop<T>(0, iter_dims.size(), get_ptr(iter_dims),
+      get_ptr(strides_a)+1, get_ptr(strides_b)+1, get_ptr(strides_c)+1, 0, nullptr,
+      a_in+strides_a[0], b_in+strides_b[0], c_in+strides_c[0]);
   }
 
+  /** \brief Numerical evaluation of an Einstein contraction
+
+      Matrix products in the innermost loops are evaluated with a blocked kernel
+      and the outermost loop is distributed over the threads of the ThreadPool.
+  */
+  template<> CASADI_EXPORT
+  void einstein_eval(casadi_int n_iter,
+      const std::vector<casadi_int>& iter_dims,
+      const std::vector<casadi_int>& strides_a, const std::vector<casadi_int>& strides_b, const std::vector<casadi_int>& strides_c,
+      const double* a_in, const double* b_in, double* c_in);
+
 }// namespace casadi
 
 #endif // CASADI_CASADI_SHARED_HPP
@@ -37,6 +37,10 @@ namespace casadi {
 
     StringSerializer::StringSerializer(const Dict& opts) :
         SerializerBase(std::unique_ptr<std::ostream>(new std::stringstream()), opts) {
+      auto it = opts.find("binary");
+      casadi_assert(it==opts.end() || !it->second.to_bool(),
+        "Option 'binary' is not supported for serialization to a string. "
+        "Use FileSerializer instead.");
     }
 
     FileSerializer::FileSerializer(const std::string& fname, const Dict& opts) :
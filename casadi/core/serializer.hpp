@@ -204,7 +204,9 @@ namespace casadi {
   class CASADI_EXPORT FileSerializer : public SerializerBase {
   public:
     /** \brief Advanced serialization of CasADi objects
-     * 
+     *
+     * Option "binary" writes raw bytes instead of text.
+     *
      * \seealso StringSerializer, FileDeserializer
      */
     FileSerializer(const std::string& fname, const Dict& opts = Dict());
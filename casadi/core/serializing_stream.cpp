@@ -39,10 +39,20 @@
 using namespace std;
 namespace casadi {
 
-    static casadi_int serialization_protocol_version = 3;
+    static casadi_int serialization_protocol_version = 4;
     static casadi_int serialization_check = 123456789012345;
 
-    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false) {
+    // Leading character of a binary stream, outside the range used by the text encoding
+    static char serialization_binary = 'B';
+
+    DeserializingStream::DeserializingStream(std::istream& in_s) :
+        in(in_s), debug_(false), binary_(false) {
+
+      // Binary stream?
+      if (in.peek()==serialization_binary) {
+        in.get();
+        binary_ = true;
+      }
 
       // Sanity check
       casadi_int check;
@@ -70,23 +80,28 @@ namespace casadi {
     }
 
     SerializingStream::SerializingStream(std::ostream& out_s, const Dict& opts) :
-        out(out_s), debug_(false) {
-      // Sanity check
-      pack(serialization_check);
-      // API version check
-      pack(casadi_int(serialization_protocol_version));
-
+        out(out_s), debug_(false), binary_(false) {
       bool debug = false;
 
       // Read options
       for (auto&& op : opts) {
         if (op.first=="debug") {
           debug = op.second;
+        } else if (op.first=="binary") {
+          binary_ = op.second;
         } else {
           casadi_error("Unknown option: '" + op.first + "'.");
         }
       }
 
+      // Binary stream
+      if (binary_) out.put(serialization_binary);
+
+      // Sanity check
+      pack(serialization_check);
+      // API version check
+      pack(casadi_int(serialization_protocol_version));
+
       pack(debug);
       debug_ = debug;
     }
@@ -106,49 +121,40 @@ namespace casadi {
     void DeserializingStream::unpack(casadi_int& e) {
       assert_decoration('J');
       int64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void SerializingStream::pack(casadi_int e) {
       decorate('J');
       int64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 8);
     }
 
     void SerializingStream::pack(size_t e) {
       decorate('K');
       uint64_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 8);
     }
 
     void DeserializingStream::unpack(size_t& e) {
       assert_decoration('K');
       uint64_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 8);
       e = n;
     }
 
     void DeserializingStream::unpack(int& e) {
       assert_decoration('i');
       int32_t n;
-      char* c = reinterpret_cast<char*>(&n);
-
-      for (int j=0;j<4;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&n), 4);
       e = n;
     }
 
     void SerializingStream::pack(int e) {
       decorate('i');
       int32_t n = e;
-      const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&n), 4);
     }
 
     void DeserializingStream::unpack(bool& e) {
@@ -164,6 +170,10 @@ namespace casadi {
     }
 
     void DeserializingStream::unpack(char& e) {
+      if (binary_) {
+        in.get(e);
+        return;
+      }
       unsigned char ref = 'a';
       in.get(e);
       char t;
@@ -173,6 +183,10 @@ namespace casadi {
     }
 
     void SerializingStream::pack(char e) {
+      if (binary_) {
+        out.put(e);
+        return;
+      }
       unsigned char ref = 'a';
       // Note: outputstreams work neatly with std::hex,
       // but inputstreams don't
@@ -180,12 +194,126 @@ namespace casadi {
       out.put(ref + (reinterpret_cast<unsigned char&>(e) >> 4));
     }
 
+    void SerializingStream::pack_raw(const char* c, size_t n) {
+      if (binary_) {
+        out.write(c, n);
+        return;
+      }
+      // Same encoding as pack(char), written in chunks
+      unsigned char ref = 'a';
+      char buf[4096];
+      while (n>0) {
+        size_t m = std::min(n, sizeof(buf)/2);
+        for (size_t j=0; j<m; ++j) {
+          unsigned char b = static_cast<unsigned char>(c[j]);
+          buf[2*j] = static_cast<char>(ref + b % 16);
+          buf[2*j+1] = static_cast<char>(ref + (b >> 4));
+        }
+        out.write(buf, 2*m);
+        c += m;
+        n -= m;
+      }
+    }
+
+    void DeserializingStream::unpack_raw(char* c, size_t n) {
+      if (binary_) {
+        in.read(c, n);
+        casadi_assert(in.gcount()==static_cast<std::streamsize>(n),
+          "DeserializingStream error: unexpected end of stream.");
+        return;
+      }
+      // Same encoding as unpack(char), read in chunks
+      unsigned char ref = 'a';
+      char buf[4096];
+      while (n>0) {
+        size_t m = std::min(n, sizeof(buf)/2);
+        in.read(buf, 2*m);
+        casadi_assert(in.gcount()==static_cast<std::streamsize>(2*m),
+          "DeserializingStream error: unexpected end of stream.");
+        for (size_t j=0; j<m; ++j) {
+          c[j] = static_cast<char>((static_cast<unsigned char>(buf[2*j])-ref) +
+                                   ((static_cast<unsigned char>(buf[2*j+1])-ref) << 4));
+        }
+        c += m;
+        n -= m;
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<casadi_int>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      decorate('J');
+      if (sizeof(casadi_int)==sizeof(int64_t)) {
+        pack_raw(reinterpret_cast<const char*>(get_ptr(e)), 8*e.size());
+      } else {
+        std::vector<int64_t> n(e.begin(), e.end());
+        pack_raw(reinterpret_cast<const char*>(get_ptr(n)), 8*n.size());
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<casadi_int>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      assert_decoration('J');
+      if (sizeof(casadi_int)==sizeof(int64_t)) {
+        e.resize(s);
+        unpack_raw(reinterpret_cast<char*>(get_ptr(e)), 8*s);
+      } else {
+        std::vector<int64_t> n(s);
+        unpack_raw(reinterpret_cast<char*>(get_ptr(n)), 8*s);
+        e.assign(n.begin(), n.end());
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<int>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      decorate('i');
+      if (sizeof(int)==sizeof(int32_t)) {
+        pack_raw(reinterpret_cast<const char*>(get_ptr(e)), 4*e.size());
+      } else {
+        std::vector<int32_t> n(e.begin(), e.end());
+        pack_raw(reinterpret_cast<const char*>(get_ptr(n)), 4*n.size());
+      }
+    }
+
+    void DeserializingStream::unpack(std::vector<int>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      assert_decoration('i');
+      if (sizeof(int)==sizeof(int32_t)) {
+        e.resize(s);
+        unpack_raw(reinterpret_cast<char*>(get_ptr(e)), 4*s);
+      } else {
+        std::vector<int32_t> n(s);
+        unpack_raw(reinterpret_cast<char*>(get_ptr(n)), 4*s);
+        e.assign(n.begin(), n.end());
+      }
+    }
+
+    void SerializingStream::pack(const std::vector<double>& e) {
+      decorate('V');
+      pack(static_cast<casadi_int>(e.size()));
+      decorate('d');
+      pack_raw(reinterpret_cast<const char*>(get_ptr(e)), 8*e.size());
+    }
+
+    void DeserializingStream::unpack(std::vector<double>& e) {
+      assert_decoration('V');
+      casadi_int s;
+      unpack(s);
+      assert_decoration('d');
+      e.resize(s);
+      unpack_raw(reinterpret_cast<char*>(get_ptr(e)), 8*s);
+    }
+
     void SerializingStream::pack(const std::string& e) {
       decorate('s');
       int s = e.size();
       pack(s);
-      const char* c = e.c_str();
-      for (int j=0;j<s;++j) pack(c[j]);
+      pack_raw(e.c_str(), s);
     }
 
     void DeserializingStream::unpack(std::string& e) {
@@ -193,19 +321,17 @@ namespace casadi {
       int s;
       unpack(s);
       e.resize(s);
-      for (int j=0;j<s;++j) unpack(e[j]);
+      unpack_raw(&e[0], s);
     }
 
     void DeserializingStream::unpack(double& e) {
       assert_decoration('d');
-      char* c = reinterpret_cast<char*>(&e);
-      for (int j=0;j<8;++j) unpack(c[j]);
+      unpack_raw(reinterpret_cast<char*>(&e), 8);
     }
 
     void SerializingStream::pack(double e) {
       decorate('d');
-      const char* c = reinterpret_cast<const char*>(&e);
-      for (int j=0;j<8;++j) pack(c[j]);
+      pack_raw(reinterpret_cast<const char*>(&e), 8);
     }
 
     void SerializingStream::pack(const Sparsity& e) {
@@ -94,6 +94,9 @@ namespace casadi {
     void unpack(std::string& e);
     void unpack(double& e);
     void unpack(char& e);
+    void unpack(std::vector<casadi_int>& e);
+    void unpack(std::vector<int>& e);
+    void unpack(std::vector<double>& e);
     template <class T>
     void unpack(std::vector<T>& e) {
       assert_decoration('V');
@@ -172,12 +175,17 @@ namespace casadi {
      */
     void assert_decoration(char e);
 
+    /** \brief Read n bytes at once */
+    void unpack_raw(char* c, size_t n);
+
     /// Collection of all shared pointer deserialized so far
     std::vector<UniversalNodeOwner> nodes;
     /// Input stream
     std::istream& in;
     /// Debug mode?
     bool debug_;
+    /// Raw bytes rather than printable characters?
+    bool binary_;
   };
 
   /** \brief Helper class for Serialization
@@ -213,6 +221,9 @@ namespace casadi {
     void pack(double e);
     void pack(const std::string& e);
     void pack(char e);
+    void pack(const std::vector<casadi_int>& e);
+    void pack(const std::vector<int>& e);
+    void pack(const std::vector<double>& e);
     template <class T>
     void pack(const std::vector<T>& e) {
       decorate('V');
@@ -249,6 +260,9 @@ namespace casadi {
      */
     void decorate(char e);
 
+    /** \brief Write n bytes at once */
+    void pack_raw(const char* c, size_t n);
+
     /* \brief Packs a shared object
     * 
     * Also treats SXNode, which is not actually a SharedObjectInternal
@@ -274,6 +288,8 @@ namespace casadi {
     std::ostream& out;
     /// Debug mode?
     bool debug_;
+    /// Raw bytes rather than printable characters?
+    bool binary_;
   };
 
   template <>
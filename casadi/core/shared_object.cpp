@@ -146,7 +146,19 @@ namespace casadi {
   SharedObject WeakRef::shared() {
     SharedObject ret;
     if (alive()) {
+#ifdef CASADI_WITH_THREAD
+      // Do not resurrect an object whose last reference is being released
+      SharedObjectInternal* raw = (*this)->raw_;
+      casadi_int c = raw->count.load();
+      while (c>0) {
+        if (raw->count.compare_exchange_weak(c, c+1)) {
+          ret.assign(raw);
+          break;
+        }
+      }
+#else // CASADI_WITH_THREAD
       ret.own((*this)->raw_);
+#endif // CASADI_WITH_THREAD
     }
     return ret;
   }
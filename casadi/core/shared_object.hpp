@@ -177,7 +177,11 @@ namespace casadi {
     /** \brief Construct from a shared object (also implicit type conversion) */
     WeakRef(SharedObject shared);
 
-    /** \brief Get a shared (owning) reference */
+    /** \brief Get a shared (owning) reference
+     *
+     * Null if the object is no longer alive, including (with WITH_THREAD) when
+     * its last reference is concurrently being released.
+     */
     SharedObject shared();
 
     /** \brief Check if alive */
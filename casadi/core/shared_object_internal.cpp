@@ -67,6 +67,10 @@ namespace casadi {
     return weak_ref_;
   }
 
+  void SharedObjectInternal::kill_weak() {
+    if (weak_ref_!=nullptr) weak_ref_->kill();
+  }
+
   WeakRefInternal::WeakRefInternal(SharedObjectInternal* raw) : raw_(raw) {
   }
 
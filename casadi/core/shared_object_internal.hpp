@@ -38,6 +38,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectInternal {
     friend class SharedObject;
+    friend class WeakRef;
     friend class Memory;
     friend class UniversalNodeOwner;
   public:
@@ -66,6 +67,9 @@ namespace casadi {
     /** \brief Get a weak reference to the object */
     WeakRef* weak();
 
+    /** \brief Invalidate the weak reference, if any, ahead of destruction */
+    void kill_weak();
+
   protected:
     /** Called in the constructor of singletons to avoid that the counter reaches zero */
     void initSingleton() {
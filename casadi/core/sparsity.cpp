@@ -31,6 +31,14 @@
 #include "serializing_stream.hpp"
 #include <climits>
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in Sparsity::" FNAME " at " + CASADI_WHERE + ":\n"\
   + std::string(WHAT));
@@ -501,9 +509,147 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
+  namespace {
+    /// One shard of the cache of sparsity patterns, selected by hash
+    struct CacheShard {
+      Sparsity::CachingMap map;
+      casadi_int hits = 0;
+      casadi_int misses = 0;
+#ifdef CASADI_WITH_THREAD
+      std::mutex mtx;
+#endif //CASADI_WITH_THREAD
+    };
+
+    // Number of shards, a power of two
+    const std::size_t n_cache_shards = 64;
+
+    /// All shards, never destroyed since patterns may be released during static destruction
+    CacheShard* cache_shards() {
+      static CacheShard* shards = new CacheShard[n_cache_shards];
+      return shards;
+    }
+
+    /// Shard for a given hash
+    CacheShard& cache_shard(std::size_t h) {
+      // Mix in the high bits, the low bits of the hash alone may be poorly distributed
+      return cache_shards()[(h ^ (h >> 17) ^ (h >> 31)) & (n_cache_shards-1)];
+    }
+
+    /// Look up a pattern in a cache shard, create and cache it if not found
+    Sparsity find_or_create(CacheShard& shard, std::size_t h, casadi_int nrow, casadi_int ncol,
+                            const casadi_int* colind, const casadi_int* row) {
+      // References obtained from the cache are released after the shard has been
+      // unlocked, since releasing the last reference to a pattern locks it again
+      std::vector<Sparsity> refs;
+      Sparsity ret;
+      Sparsity::CachingMap& cache = shard.map;
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif //CASADI_WITH_THREAD
+
+      // Record the current number of buckets (for garbage collection below)
+      casadi_int bucket_count_before = cache.bucket_count();
+
+      // WORKAROUND, functions do not appear to work when bucket_count==0
+      if (bucket_count_before>0) {
+
+        // Find the range of patterns equal to the key (normally only zero or one)
+        auto eq = cache.equal_range(h);
+
+        // Loop over maching patterns
+        for (auto i=eq.first; i!=eq.second; ++i) {
+
+          // Get an owning reference to the cached pattern, if it still exists
+          refs.push_back(shared_cast<Sparsity>(i->second.shared()));
+          if (!refs.back().is_null()) {
+            // Check if the pattern matches
+            if (refs.back().is_equal(nrow, ncol, colind, row)) {
+              // Found match!
+              shard.hits++;
+              return refs.back();
+            }
+            // There is a hash collision (unlikely, but possible)
+            // Leave the pattern alone, continue to the next matching pattern
+          } else {
+
+            // Check if one of the other cache entries indeed has a matching sparsity
+            auto j=i;
+            j++; // Start at the next matching key
+            for (; j!=eq.second; ++j) {
+              // Recover cached sparsity
+              refs.push_back(shared_cast<Sparsity>(j->second.shared()));
+
+              // Match found if sparsity matches
+              if (!refs.back().is_null() && refs.back().is_equal(nrow, ncol, colind, row)) {
+                shard.hits++;
+                return refs.back();
+              }
+            }
+
+            // The cached entry has been deleted, create a new one
+            shard.misses++;
+            SparsityInternal* node = new SparsityInternal(nrow, ncol, colind, row);
+            node->set_cache_shard(&shard - cache_shards());
+            ret = Sparsity::create(node);
+
+            // Cache this pattern
+            i->second = ret;
+            return ret;
+          }
+        }
+      }
+
+      // No matching sparsity pattern could be found, create a new one
+      shard.misses++;
+      SparsityInternal* node = new SparsityInternal(nrow, ncol, colind, row);
+      node->set_cache_shard(&shard - cache_shards());
+      ret = Sparsity::create(node);
+
+      // Cache this pattern
+      cache.insert(std::pair<std::size_t, WeakRef>(h, ret));
+
+      // Garbage collection (currently only supported for unordered_multimap)
+      casadi_int bucket_count_after = cache.bucket_count();
+
+      // We we increased the number of buckets, take time to garbage-collect deleted references
+      if (bucket_count_before!=bucket_count_after) {
+        auto i=cache.begin();
+        while (i!=cache.end()) {
+          if (!i->second.alive()) {
+            i = cache.erase(i);
+          } else {
+            i++;
+          }
+        }
+      }
+      return ret;
+    }
+  } // namespace
+
+  Dict Sparsity::cache_stats() {
+    casadi_int hits = 0, misses = 0, size = 0, n_alive = 0;
+    for (std::size_t k=0; k<n_cache_shards; ++k) {
+      CacheShard& shard = cache_shards()[k];
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif //CASADI_WITH_THREAD
+      hits += shard.hits;
+      misses += shard.misses;
+      size += shard.map.size();
+      for (auto&& e : shard.map) if (e.second.alive()) n_alive++;
+    }
+    return {{"hits", hits}, {"misses", misses}, {"size", size}, {"n_alive", n_alive},
+            {"n_shards", static_cast<casadi_int>(n_cache_shards)}};
+  }
+
+  void Sparsity::uncache(SparsityInternal* node) {
+#ifdef CASADI_WITH_THREAD
+    // Patterns that were never cached cannot be picked up by a lookup
+    if (node->cache_shard()<0) return;
+    CacheShard& shard = cache_shards()[node->cache_shard()];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    node->kill_weak();
+#endif //CASADI_WITH_THREAD
   }
 
   const Sparsity& Sparsity::getScalar() {
@@ -630,6 +776,47 @@ namespace casadi {
     return Sparsity(n, n, L_colind, L_row, true).T();
   }
 
+  Sparsity Sparsity::ldl_super(std::vector<casadi_int>& p, Sparsity& super, bool amd) const {
+    casadi_assert(is_symmetric(),
+                 "LDL factorization requires a symmetric matrix");
+    // Dimension
+    casadi_int n=size1();
+    // Fill-reducing ordering
+    p = amd ? this->amd() : range(n);
+    std::vector<casadi_int> tmp;
+    Sparsity Aperm = sub(p, p, tmp);
+    // Postorder the elimination tree, does not change the fill-in
+    std::vector<casadi_int> parent = Aperm.etree(), post(n), w(3*n);
+    SparsityInternal::postorder(get_ptr(parent), n, get_ptr(post), get_ptr(w));
+    Aperm = Aperm.sub(post, post, tmp);
+    for (casadi_int i=0; i<n; ++i) w[i] = p[post[i]];
+    std::copy(w.begin(), w.begin()+n, p.begin());
+    // Symbolic factorization
+    Sparsity Lt = Aperm.ldl(tmp, false);
+    Sparsity L = Lt.T();
+    const casadi_int *L_colind = L.colind(), *L_row = L.row();
+    // Fundamental supernodes: column c+1 joins the supernode of column c if it
+    // is its parent and column c of L has the same rows as column c+1, plus c+1
+    std::vector<casadi_int> s_colind(1, 0), s_row;
+    casadi_int c=0;
+    while (c<n) {
+      casadi_int f = c;
+      while (c+1<n) {
+        casadi_int cnt = L_colind[c+1]-L_colind[c];
+        if (cnt==0 || L_row[L_colind[c]]!=c+1
+            || cnt!=L_colind[c+2]-L_colind[c+1]+1) break;
+        c++;
+      }
+      c++;
+      // Dense panel: the columns of the supernode, then the rows below
+      for (casadi_int i=f; i<c; ++i) s_row.push_back(i);
+      for (casadi_int k=L_colind[c-1]; k<L_colind[c]; ++k) s_row.push_back(L_row[k]);
+      s_colind.push_back(s_row.size());
+    }
+    super = Sparsity(n, s_colind.size()-1, s_colind, s_row);
+    return Lt;
+  }
+
   void Sparsity::
   qr_sparse(Sparsity& V, Sparsity& R, std::vector<casadi_int>& prinv,
             std::vector<casadi_int>& pc, bool amd) const {
@@ -853,92 +1040,8 @@ namespace casadi {
     // Hash the pattern
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
-    // Get a reference to the cache
-    CachingMap& cache = getCache();
-
-    // Record the current number of buckets (for garbage collection below)
-    casadi_int bucket_count_before = cache.bucket_count();
-
-    // WORKAROUND, functions do not appear to work when bucket_count==0
-    if (bucket_count_before>0) {
-
-      // Find the range of patterns equal to the key (normally only zero or one)
-      pair<CachingMap::iterator, CachingMap::iterator> eq = cache.equal_range(h);
-
-      // Loop over maching patterns
-      for (CachingMap::iterator i=eq.first; i!=eq.second; ++i) {
-
-        // Get a weak reference to the cached sparsity pattern
-        WeakRef& wref = i->second;
-
-        // Check if the pattern still exists
-        if (wref.alive()) {
-
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
-
-          // Check if the pattern matches
-          if (ref.is_equal(nrow, ncol, colind, row)) {
-
-            // Found match!
-            own(ref.get());
-            return;
-
-          } else { // There is a hash rowision (unlikely, but possible)
-            // Leave the pattern alone, continue to the next matching pattern
-            continue;
-          }
-        } else {
-
-          // Check if one of the other cache entries indeed has a matching sparsity
-          CachingMap::iterator j=i;
-          j++; // Start at the next matching key
-          for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
-
-              // Match found if sparsity matches
-              if (ref.is_equal(nrow, ncol, colind, row)) {
-                own(ref.get());
-                return;
-              }
-            }
-          }
-
-          // The cached entry has been deleted, create a new one
-          own(new SparsityInternal(nrow, ncol, colind, row));
-
-          // Cache this pattern
-          wref = *this;
-
-          // Return
-          return;
-        }
-      }
-    }
-
-    // No matching sparsity pattern could be found, create a new one
-    own(new SparsityInternal(nrow, ncol, colind, row));
-
-    // Cache this pattern
-    cache.insert(std::pair<std::size_t, WeakRef>(h, *this));
-
-    // Garbage collection (currently only supported for unordered_multimap)
-    casadi_int bucket_count_after = cache.bucket_count();
-
-    // We we increased the number of buckets, take time to garbage-collect deleted references
-    if (bucket_count_before!=bucket_count_after) {
-      CachingMap::const_iterator i=cache.begin();
-      while (i!=cache.end()) {
-        if (!i->second.alive()) {
-          i = cache.erase(i);
-        } else {
-          i++;
-        }
-      }
-    }
+    // Look up in the cache
+    *this = find_or_create(cache_shard(h), h, nrow, ncol, colind, row);
   }
 
   Sparsity Sparsity::tril(const Sparsity& x, bool includeDiagonal) {
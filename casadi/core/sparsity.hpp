@@ -655,11 +655,25 @@ namespace casadi {
     */
     void removeDuplicates(std::vector<casadi_int>& SWIG_INOUT(mapping));
 
+    /** \brief Statistics of the cache of sparsity patterns
+     *
+     * Number of cache hits and misses since start-up, number of cache
+     * entries (including expired ones not yet garbage collected), number of
+     * entries referring to live patterns and number of shards.
+     */
+    static Dict cache_stats();
+
 #ifndef SWIG
     typedef std::unordered_multimap<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
+    /// \cond INTERNAL
+    /** \brief Invalidate the cache entry of a pattern being destroyed
+     *
+     * Called from the SparsityInternal destructor. Synchronizes with lookups
+     * in assign_cached, which may otherwise pick up a dying pattern.
+     */
+    static void uncache(SparsityInternal* node);
+    /// \endcond
 
     /// (Dense) scalar
     static const Sparsity& getScalar();
@@ -693,6 +707,17 @@ namespace casadi {
     */
     Sparsity ldl(std::vector<casadi_int>& SWIG_OUTPUT(p), bool amd=true) const;
 
+    /** \brief Symbolic supernodal LDL factorization
+        Returns the sparsity pattern of L^T, as ldl, but with the elimination
+        tree postordered so that chains of columns are numbered consecutively.
+        Columns of L with identical structure below the diagonal are grouped into
+        supernodes. Column s of the n-by-nsuper pattern super holds the rows of
+        the dense panel of supernode s: its own columns followed by the rows of L
+        below them.
+    */
+    Sparsity ldl_super(std::vector<casadi_int>& SWIG_OUTPUT(p),
+                       Sparsity& SWIG_OUTPUT(super), bool amd=true) const;
+
     /** \brief Symbolic QR factorization
         Returns the sparsity pattern of V (compact representation of Q) and R
         as well as vectors needed for the numerical factorization and solution.
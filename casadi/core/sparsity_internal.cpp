@@ -27,9 +27,11 @@
 #include "sparsity_internal.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
 #include <climits>
 #include <cstdlib>
 #include <cmath>
+#include <atomic>
 
 using namespace std;
 
@@ -451,7 +453,7 @@ namespace casadi {
   SparsityInternal::
   SparsityInternal(casadi_int nrow, casadi_int ncol,
       const casadi_int* colind, const casadi_int* row) :
-    sp_(2 + ncol+1 + colind[ncol]), btf_(nullptr) {
+    sp_(2 + ncol+1 + colind[ncol]), btf_(nullptr), cache_shard_(-1) {
     sp_[0] = nrow;
     sp_[1] = ncol;
     std::copy(colind, colind+ncol+1, sp_.begin()+2);
@@ -459,6 +461,7 @@ namespace casadi {
   }
 
   SparsityInternal::~SparsityInternal() {
+    Sparsity::uncache(this);
     delete btf_;
   }
 
@@ -3354,6 +3357,259 @@ namespace casadi {
     return Sparsity::triplet(size2(), num_colors, range(color.size()), color);
   }
 
+  namespace {
+    // Number of vertices per task in the parallel colorings
+    const casadi_int COLORING_BLOCK = 256;
+
+    /// Renumber colors consecutively, dropping unused colors, returns the number of colors
+    casadi_int compact_colors(const std::vector<std::atomic<casadi_int> >& color,
+                              std::vector<casadi_int>& ret) {
+      ret.resize(color.size());
+      std::vector<casadi_int> map;
+      for (casadi_int i=0; i<color.size(); ++i) {
+        casadi_int c = color[i].load(std::memory_order_relaxed);
+        if (c>=map.size()) map.resize(c+1, -1);
+        ret[i] = c;
+        map[c] = 1;
+      }
+      casadi_int n_colors = 0;
+      for (casadi_int& m : map) if (m>=0) m = n_colors++;
+      for (casadi_int& c : ret) c = map[c];
+      return n_colors;
+    }
+
+    /// Get the smallest color not marked with stamp s
+    casadi_int first_allowed(const std::vector<casadi_int>& forbidden, casadi_int s) {
+      casadi_int c = 0;
+      while (c<forbidden.size() && forbidden[c]==s) c++;
+      return c;
+    }
+
+    /// Mark color c with stamp s
+    void forbid(std::vector<casadi_int>& forbidden, casadi_int c, casadi_int s) {
+      if (c>=forbidden.size()) forbidden.resize(c+1, 0);
+      forbidden[c] = s;
+    }
+  } // namespace
+
+  Sparsity SparsityInternal::uni_coloring_parallel(const Sparsity& AT, casadi_int cutoff) const {
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = pool.size();
+    if (nw==1) return uni_coloring(AT, cutoff);
+
+    // Access the sparsity of the transpose
+    const casadi_int* AT_colind = AT.colind();
+    const casadi_int* AT_row = AT.row();
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+
+    // Tentative colors, read and written concurrently
+    vector<atomic<casadi_int> > color(size2());
+    for (auto&& c : color) c.store(-1, memory_order_relaxed);
+
+    // Forbidden colors for each worker, marked with a running stamp
+    vector<vector<casadi_int> > forbidden(nw);
+    vector<casadi_int> stamp(nw, 0);
+    atomic<bool> too_many(false);
+
+    // Columns to be (re)colored
+    vector<casadi_int> U = range(size2());
+    vector<char> conflict;
+    while (!U.empty()) {
+      casadi_int n_blocks = (U.size()+COLORING_BLOCK-1)/COLORING_BLOCK;
+
+      // Speculative coloring, neighbors may be colored concurrently
+      pool.run(n_blocks, nw, [&](casadi_int b, casadi_int wk) {
+        vector<casadi_int>& fc = forbidden[wk];
+        casadi_int k_end = std::min(static_cast<casadi_int>(U.size()), (b+1)*COLORING_BLOCK);
+        for (casadi_int k=b*COLORING_BLOCK; k<k_end; ++k) {
+          casadi_int i = U[k], s = ++stamp[wk];
+          for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+            casadi_int c = row[el];
+            for (casadi_int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+              casadi_int i2 = AT_row[el2];
+              if (i2==i) continue;
+              casadi_int color_i2 = color[i2].load(memory_order_relaxed);
+              if (color_i2>=0) forbid(fc, color_i2, s);
+            }
+          }
+          casadi_int color_i = first_allowed(fc, s);
+          if (color_i>=cutoff) too_many = true;
+          color[i].store(color_i, memory_order_relaxed);
+        }
+      });
+      if (too_many) return Sparsity();
+
+      // Conflict detection: of two neighbors with the same color, the larger is recolored
+      conflict.assign(U.size(), 0);
+      pool.run(n_blocks, nw, [&](casadi_int b, casadi_int wk) {
+        casadi_int k_end = std::min(static_cast<casadi_int>(U.size()), (b+1)*COLORING_BLOCK);
+        for (casadi_int k=b*COLORING_BLOCK; k<k_end; ++k) {
+          casadi_int i = U[k];
+          casadi_int color_i = color[i].load(memory_order_relaxed);
+          for (casadi_int el=colind[i]; el<colind[i+1] && !conflict[k]; ++el) {
+            casadi_int c = row[el];
+            for (casadi_int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+              casadi_int i2 = AT_row[el2];
+              if (i2>=i) break;
+              if (color[i2].load(memory_order_relaxed)==color_i) {
+                conflict[k] = 1;
+                break;
+              }
+            }
+          }
+        }
+      });
+
+      // Recolor conflicting columns
+      casadi_int n_conflict = 0;
+      for (casadi_int k=0; k<U.size(); ++k) {
+        if (conflict[k]) U[n_conflict++] = U[k];
+      }
+      U.resize(n_conflict);
+    }
+
+    // Return the coloring
+    vector<casadi_int> ret_color;
+    casadi_int n_colors = compact_colors(color, ret_color);
+    return Sparsity::triplet(size2(), n_colors, range(size2()), ret_color);
+  }
+
+  Sparsity SparsityInternal::star_coloring_parallel(casadi_int ordering, casadi_int cutoff) const {
+    ThreadPool& pool = ThreadPool::instance();
+    casadi_int nw = pool.size();
+    if (nw==1) return star_coloring(ordering, cutoff);
+
+    if (!is_square()) {
+      casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
+    }
+
+    // Reorder, if necessary
+    if (ordering!=0) {
+      casadi_assert_dev(ordering==1);
+      vector<casadi_int> ord = largest_first();
+      Sparsity sp_permuted = pmult(ord, true, true, true);
+      Sparsity ret_permuted = sp_permuted->star_coloring_parallel(0, cutoff);
+      if (ret_permuted.is_null()) return ret_permuted;
+      return ret_permuted.pmult(ord, true, false, false);
+    }
+
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+
+    // Tentative colors, read and written concurrently
+    vector<atomic<casadi_int> > color(size2());
+    for (auto&& c : color) c.store(-1, memory_order_relaxed);
+
+    // Forbidden colors for each worker, marked with a running stamp
+    vector<vector<casadi_int> > forbidden(nw);
+    vector<casadi_int> stamp(nw, 0);
+
+    // Vertices to be (re)colored and vertices involved in a conflict
+    vector<casadi_int> U = range(size2());
+    vector<char> conflict(size2());
+    casadi_int n_blocks_all = (size2()+COLORING_BLOCK-1)/COLORING_BLOCK;
+
+    // Rounds of speculative coloring before giving up on conflict resolution
+    const casadi_int max_rounds = 8;
+    for (casadi_int round=0; !U.empty() && round<max_rounds; ++round) {
+      casadi_int n_blocks = (U.size()+COLORING_BLOCK-1)/COLORING_BLOCK;
+
+      // Speculative coloring, using the rules of star_coloring
+      pool.run(n_blocks, nw, [&](casadi_int b, casadi_int wk) {
+        vector<casadi_int>& fc = forbidden[wk];
+        casadi_int k_end = std::min(static_cast<casadi_int>(U.size()), (b+1)*COLORING_BLOCK);
+        for (casadi_int k=b*COLORING_BLOCK; k<k_end; ++k) {
+          casadi_int v = U[k], s = ++stamp[wk];
+          for (casadi_int w_el=colind[v]; w_el<colind[v+1]; ++w_el) {
+            casadi_int w = row[w_el];
+            if (w==v) continue;
+            casadi_int color_w = color[w].load(memory_order_relaxed);
+            if (color_w>=0) forbid(fc, color_w, s);
+            for (casadi_int x_el=colind[w]; x_el<colind[w+1]; ++x_el) {
+              casadi_int x = row[x_el];
+              if (x==v) continue;
+              casadi_int color_x = color[x].load(memory_order_relaxed);
+              if (color_x<0) continue;
+              if (color_w<0) {
+                forbid(fc, color_x, s);
+              } else {
+                for (casadi_int y_el=colind[x]; y_el<colind[x+1]; ++y_el) {
+                  casadi_int y = row[y_el];
+                  if (y==w) continue;
+                  if (color[y].load(memory_order_relaxed)==color_w) {
+                    forbid(fc, color_x, s);
+                    break;
+                  }
+                }
+              }
+            }
+          }
+          color[v].store(first_allowed(fc, s), memory_order_relaxed);
+        }
+      });
+
+      // Conflict detection over all vertices. Neighbors sharing a color and
+      // two-colored paths a-b-c-d are resolved by the larger of the two
+      // vertices in question (b and c for the path)
+      pool.run(n_blocks_all, nw, [&](casadi_int b, casadi_int wk) {
+        casadi_int v_end = std::min(size2(), (b+1)*COLORING_BLOCK);
+        for (casadi_int v=b*COLORING_BLOCK; v<v_end; ++v) {
+          conflict[v] = 0;
+          casadi_int color_v = color[v].load(memory_order_relaxed);
+          if (color_v<0) continue;
+          for (casadi_int c_el=colind[v]; c_el<colind[v+1] && !conflict[v]; ++c_el) {
+            casadi_int c = row[c_el];
+            if (c>=v) continue;
+            casadi_int color_c = color[c].load(memory_order_relaxed);
+            if (color_c<0) continue;
+            if (color_c==color_v) {
+              conflict[v] = 1;
+              break;
+            }
+            // Is there a path a-v-c-d with color[a]==color[c], color[d]==color[v]?
+            bool has_a = false;
+            for (casadi_int a_el=colind[v]; a_el<colind[v+1] && !has_a; ++a_el) {
+              casadi_int a = row[a_el];
+              has_a = a!=c && a!=v && color[a].load(memory_order_relaxed)==color_c;
+            }
+            if (!has_a) continue;
+            for (casadi_int d_el=colind[c]; d_el<colind[c+1]; ++d_el) {
+              casadi_int d = row[d_el];
+              if (d!=v && d!=c && color[d].load(memory_order_relaxed)==color_v) {
+                conflict[v] = 1;
+                break;
+              }
+            }
+          }
+        }
+      });
+
+      // Uncolor and recolor the vertices in conflict
+      U.clear();
+      for (casadi_int v=0; v<size2(); ++v) {
+        if (conflict[v]) {
+          U.push_back(v);
+          color[v].store(-1, memory_order_relaxed);
+        }
+      }
+    }
+
+    // The remaining colored vertices form a valid star coloring: give the
+    // vertices with unresolved conflicts colors of their own
+    if (!U.empty()) {
+      casadi_int n_colors = 0;
+      for (auto&& c : color) n_colors = std::max(n_colors, c.load(memory_order_relaxed)+1);
+      for (casadi_int v : U) color[v].store(n_colors++, memory_order_relaxed);
+    }
+
+    // Return the coloring
+    vector<casadi_int> ret_color;
+    casadi_int n_colors = compact_colors(color, ret_color);
+    if (n_colors>cutoff) return Sparsity();
+    return Sparsity::triplet(size2(), n_colors, range(size2()), ret_color);
+  }
+
   std::vector<casadi_int> SparsityInternal::largest_first() const {
     vector<casadi_int> degree = get_colind();
     casadi_int max_degree = 0;
@@ -56,6 +56,9 @@ namespace casadi {
     */
     mutable Btf* btf_;
 
+    /* \brief Shard of the pattern cache referring to the pattern, -1 if not cached */
+    casadi_int cache_shard_;
+
   public:
     /// Construct a sparsity pattern from arrays
     SparsityInternal(casadi_int nrow, casadi_int ncol,
@@ -64,6 +67,10 @@ namespace casadi {
     /// Destructor
     ~SparsityInternal() override;
 
+    /// Shard of the pattern cache referring to the pattern, -1 if not cached
+    casadi_int cache_shard() const { return cache_shard_;}
+    void set_cache_shard(casadi_int k) { cache_shard_ = k;}
+
     /** \brief Get number of rows (see public class) */
     inline const std::vector<casadi_int>& sp() const { return sp_;}
 
@@ -599,6 +606,23 @@ namespace casadi {
      */
     Sparsity star_coloring2(casadi_int ordering, casadi_int cutoff) const;
 
+    /** \brief Multithreaded unidirectional coloring
+     *
+     * Speculative greedy coloring with iterative conflict resolution
+     * (Bozdag, Gebremedhin, Manne, Boman, Catalyurek, J. Parallel Distrib. Comput. 2008),
+     * executed on the ThreadPool. Falls back to uni_coloring with a single thread.
+     */
+    Sparsity uni_coloring_parallel(const Sparsity& AT, casadi_int cutoff) const;
+
+    /** \brief Multithreaded star coloring
+     *
+     * Speculative variant of star_coloring: vertices are colored concurrently,
+     * the coloring is then checked for adjacent vertices sharing a color and for
+     * two-colored paths on four vertices, and offending vertices are recolored.
+     * Falls back to star_coloring with a single thread.
+     */
+    Sparsity star_coloring_parallel(casadi_int ordering, casadi_int cutoff) const;
+
     /// Order the columns by decreasing degree
     std::vector<casadi_int> largest_first() const;
 
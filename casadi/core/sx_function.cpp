@@ -30,6 +30,7 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <functional>
 #include "casadi_misc.hpp"
 #include "sx_node.hpp"
 #include "casadi_common.hpp"
@@ -42,6 +43,24 @@ namespace casadi {
 
   using namespace std;
 
+  /** \brief Superinstructions of the SXElem virtual machine, see SXFunction::init_fused
+   * The numbering continues after the built-in operations.
+   */
+  enum FusedOperation {
+    // w[i0] = w[i1]*w[i2] + w[i3]
+    FUSED_MUL_ADD = NUM_BUILT_IN_OPS,
+    // w[i0] = w[i1]*w[i2] - w[i3]
+    FUSED_MUL_SUB,
+    // w[i0] = w[i3] - w[i1]*w[i2]
+    FUSED_MUL_RSUB,
+    // w[i0] = w[i1] + d, w[i0] = w[i1] - d, w[i0] = d - w[i1]
+    FUSED_ADD_IMM, FUSED_SUB_IMM, FUSED_RSUB_IMM,
+    // w[i0] = w[i1] * d, w[i0] = w[i1] / d, w[i0] = d / w[i1]
+    FUSED_MUL_IMM, FUSED_DIV_IMM, FUSED_RDIV_IMM,
+    // w[i0] = pow(w[i1], d)
+    FUSED_POW_IMM
+  };
+
 
   SXFunction::SXFunction(const std::string& name,
                          const vector<SX >& inputv,
@@ -75,6 +94,32 @@ namespace casadi {
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
 
+    // Evaluate the algorithm with superinstructions
+    if (fuse_instructions_) {
+      for (auto&& e : fused_) {
+        switch (e.op) {
+          CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
+
+        case OP_CONST: w[e.i0] = e.d; break;
+        case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
+        case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
+        case FUSED_MUL_ADD: w[e.i0] = w[e.i1]*w[e.i2] + w[e.i3]; break;
+        case FUSED_MUL_SUB: w[e.i0] = w[e.i1]*w[e.i2] - w[e.i3]; break;
+        case FUSED_MUL_RSUB: w[e.i0] = w[e.i3] - w[e.i1]*w[e.i2]; break;
+        case FUSED_ADD_IMM: w[e.i0] = w[e.i1] + e.d; break;
+        case FUSED_SUB_IMM: w[e.i0] = w[e.i1] - e.d; break;
+        case FUSED_RSUB_IMM: w[e.i0] = e.d - w[e.i1]; break;
+        case FUSED_MUL_IMM: w[e.i0] = w[e.i1] * e.d; break;
+        case FUSED_DIV_IMM: w[e.i0] = w[e.i1] / e.d; break;
+        case FUSED_RDIV_IMM: w[e.i0] = e.d / w[e.i1]; break;
+        case FUSED_POW_IMM: w[e.i0] = pow(w[e.i1], e.d); break;
+        default:
+          casadi_error("Unknown operation" + str(e.op));
+        }
+      }
+      return 0;
+    }
+
     // Evaluate the algorithm
     for (auto&& e : algorithm_) {
       switch (e.op) {
@@ -90,6 +135,59 @@ namespace casadi {
     return 0;
   }
 
+  template<casadi_int N>
+  void SXFunction::eval_lanes(const double** arg, double** res, double* w,
+      casadi_int offset) const {
+    // Work vector element k of lane l is stored at w[k*N + l]
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w+e.i1*N, w+e.i2*N, w+e.i0*N, N)
+
+      case OP_CONST: std::fill_n(w+e.i0*N, N, e.d); break;
+      case OP_INPUT:
+        if (arg[e.i1]==nullptr) {
+          std::fill_n(w+e.i0*N, N, 0.);
+        } else {
+          casadi_int nnz = sparsity_in_[e.i1].nnz();
+          const double* a = arg[e.i1] + offset*nnz + e.i2;
+          for (casadi_int l=0; l<N; ++l) w[e.i0*N+l] = a[l*nnz];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          casadi_int nnz = sparsity_out_[e.i0].nnz();
+          double* r = res[e.i0] + offset*nnz + e.i2;
+          for (casadi_int l=0; l<N; ++l) r[l*nnz] = w[e.i1*N+l];
+        }
+        break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+    }
+  }
+
+  int SXFunction::eval_batch(const double** arg, double** res, double* w, casadi_int n) const {
+    if (verbose_) casadi_message(name_ + "::eval_batch");
+    casadi_assert(has_eval_batch(), "Batched evaluation not possible for " + name_);
+
+    // Full blocks
+    casadi_int offset = 0;
+    for (; offset+batch_size<=n; offset+=batch_size) {
+      eval_lanes<batch_size>(arg, res, w, offset);
+    }
+
+    // Remaining points, one at a time
+    for (; offset<n; ++offset) eval_lanes<1>(arg, res, w, offset);
+    return 0;
+  }
+
+  bool SXFunction::has_eval_batch() const {
+    // Bypasses FunctionInternal::eval_gen, so no compiled code, timing, printing
+    // or dumping can be requested
+    return free_vars_.empty() && !eval_ && !record_time_ && !print_in_ && !print_out_
+      && !dump_in_ && !dump_out_ && !dump_;
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -178,6 +276,54 @@ namespace casadi {
     }
   }
 
+  void SXFunction::codegen_batch(CodeGenerator& g) const {
+    // Work vector element k of lane l is stored at w[k*nl + l]
+    casadi_int nl = g.batch_width;
+    auto wl = [&](casadi_int k) { return "w[" + str(k*nl) + "+l]";};
+
+    // Loop over all lanes, optionally with a vectorization directive
+    string lanes = g.batch_simd ? "#pragma omp simd\n" : "";
+    lanes += "for (l=0; l<" + str(nl) + "; ++l) ";
+
+    g << g.declare("int " + name_ + "_batch(const casadi_real** arg, casadi_real** res, "
+                   "casadi_int* iw, casadi_real* w, int mem, casadi_int n)") << " {\n"
+      << "casadi_int j, l, nb;\n"
+      << "for (j=0; j<n; j+=" << nl << ") {\n"
+      << "nb = n-j<" << nl << " ? n-j : " << nl << ";\n";
+
+    // Run the algorithm for a block of points
+    for (auto&& a : algorithm_) {
+      if (a.op==OP_OUTPUT) {
+        g << "if (res[" << a.i0 << "]) for (l=0; l<nb; ++l) "
+          << "res[" << a.i0 << "][" << a.i2 << "*n+j+l]=" << wl(a.i1) << ";\n";
+      } else if (a.op==OP_INPUT) {
+        // Lanes beyond the last point are set to zero
+        g << "if (arg[" << a.i1 << "]) {\n"
+          << "for (l=0; l<nb; ++l) " << wl(a.i0) << "=arg[" << a.i1 << "]["
+          << a.i2 << "*n+j+l];\n"
+          << "for (; l<" << nl << "; ++l) " << wl(a.i0) << "=0;\n"
+          << "} else {\n"
+          << lanes << wl(a.i0) << "=0;\n"
+          << "}\n";
+      } else if (a.op==OP_CONST) {
+        g << lanes << wl(a.i0) << "=" << g.constant(a.d) << ";\n";
+      } else {
+        casadi_int ndep = casadi_math<double>::ndeps(a.op);
+        casadi_assert_dev(ndep>0);
+        g << lanes << wl(a.i0) << "=";
+        if (ndep==1) g << g.print_op(a.op, wl(a.i1));
+        if (ndep==2) g << g.print_op(a.op, wl(a.i1), wl(a.i2));
+        g << ";\n";
+      }
+    }
+    g << "}\n"
+      << "return 0;\n"
+      << "}\n\n";
+
+    // Work vector lengths
+    codegen_batch_work(g, sz_arg(), sz_res(), sz_iw(), worksize_*nl);
+  }
+
   const Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -192,7 +338,15 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"reorder_instructions",
+       {OT_BOOL,
+        "Reorder the instructions to shorten the live ranges in the work vector "
+        "and reuse the lowest free work vector elements first"}},
+      {"fuse_instructions",
+       {OT_BOOL,
+        "Fuse common instruction sequences (multiply-add, constant operands) "
+        "into superinstructions for numerical evaluation"}}
      }
   };
 
@@ -200,6 +354,8 @@ namespace casadi {
     Dict opts = FunctionInternal::generate_options(is_temp);
     //opts["default_in"] = default_in_;
     opts["live_variables"] = live_variables_;
+    opts["reorder_instructions"] = reorder_instructions_;
+    opts["fuse_instructions"] = fuse_instructions_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
     return opts;
@@ -212,6 +368,8 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    reorder_instructions_ = false;
+    fuse_instructions_ = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -219,6 +377,10 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="reorder_instructions") {
+        reorder_instructions_ = op.second;
+      } else if (op.first=="fuse_instructions") {
+        fuse_instructions_ = op.second;
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
@@ -255,6 +417,10 @@ namespace casadi {
     }
 
     casadi_assert(nodes.size() <= std::numeric_limits<int>::max(), "Integer overflow");
+
+    // Shorten the live ranges of the work vector elements
+    if (live_variables_ && reorder_instructions_) reorder_nodes(nodes);
+
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
       if (nodes[i]) {
@@ -353,8 +519,8 @@ namespace casadi {
     // Place in the work vector for each of the nodes in the tree (overwrites the reference counter)
     vector<int> place(nodes.size());
 
-    // Stack with unused elements in the work vector
-    stack<int> unused;
+    // Unused elements in the work vector, a stack or, when reordering, a min-heap
+    vector<int> unused;
 
     // Work vector size
     int worksize = 0;
@@ -370,15 +536,19 @@ namespace casadi {
       for (casadi_int c=ndeps-1; c>=0; --c) {
         casadi_int ch_ind = c==0 ? a.i1 : a.i2;
         casadi_int remaining = --refcount.at(ch_ind);
-        if (remaining==0) unused.push(place[ch_ind]);
+        if (remaining==0) {
+          unused.push_back(place[ch_ind]);
+          if (reorder_instructions_) push_heap(unused.begin(), unused.end(), greater<int>());
+        }
       }
 
       // Find a place to store the variable
       if (a.op!=OP_OUTPUT) {
         if (live_variables_ && !unused.empty()) {
-          // Try to reuse a variable from the stack if possible (last in, first out)
-          a.i0 = place[a.i0] = unused.top();
-          unused.pop();
+          // Try to reuse a variable, the last one freed or, when reordering, the lowest one
+          if (reorder_instructions_) pop_heap(unused.begin(), unused.end(), greater<int>());
+          a.i0 = place[a.i0] = unused.back();
+          unused.pop_back();
         } else {
           // Allocate a new variable
           a.i0 = place[a.i0] = worksize++;
@@ -460,6 +630,9 @@ namespace casadi {
       }
     }
 
+    // Superinstructions for numerical evaluation
+    if (fuse_instructions_) init_fused();
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     if (just_in_time_opencl_) {
       casadi_error("OpenCL is not supported in this version of CasADi");
@@ -474,6 +647,256 @@ namespace casadi {
     if (verbose_) casadi_message(str(algorithm_.size()) + " elementary operations");
   }
 
+  void SXFunction::reorder_nodes(std::vector<SXNode*>& nodes) const {
+    casadi_int n = nodes.size();
+
+    // Position of each node in the depth-first order
+    for (casadi_int i=0; i<n; ++i) {
+      if (nodes[i]) nodes[i]->temp = static_cast<int>(i);
+    }
+
+    // Dependencies of each instruction, outputs depending on the corresponding expression
+    vector<casadi_int> dep(2*n, -1);
+    vector<casadi_int> out_ind;
+    for (auto&& o : out_) {
+      for (auto&& e : o.nonzeros()) out_ind.push_back(e.get()->temp);
+    }
+    casadi_int k = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      if (nodes[i]) {
+        for (casadi_int c=0; c<nodes[i]->n_dep(); ++c) {
+          dep[2*i+c] = nodes[i]->dep(c).get()->temp;
+        }
+      } else {
+        dep[2*i] = out_ind.at(k++);
+      }
+    }
+
+    // Largest number of simultaneously live work vector elements for an ordering
+    auto peak_work = [&](const vector<casadi_int>& order) {
+      vector<casadi_int> refcount(n, 0);
+      for (casadi_int d : dep) if (d>=0) refcount[d]++;
+      casadi_int live = 0, peak = 0;
+      for (casadi_int i : order) {
+        for (casadi_int c=0; c<2; ++c) {
+          casadi_int d = dep[2*i+c];
+          if (d>=0 && --refcount[d]==0) live--;
+        }
+        if (nodes[i]) peak = std::max(peak, ++live);
+      }
+      return peak;
+    };
+
+    // Number of work vector elements needed to evaluate each node (Sethi-Ullman number)
+    vector<casadi_int> need(n, 1);
+    for (casadi_int i=0; i<n; ++i) {
+      casadi_int d0 = dep[2*i], d1 = dep[2*i+1];
+      if (!nodes[i] || d0<0) continue;
+      if (d1<0) {
+        need[i] = need[d0];
+      } else {
+        need[i] = need[d0]==need[d1] ? need[d0]+1 : std::max(need[d0], need[d1]);
+      }
+    }
+
+    // Depth-first search, visiting the dependency with the largest need first
+    vector<casadi_int> order;
+    order.reserve(n);
+    vector<char> visited(n, 0), added(n, 0);
+    vector<casadi_int> s;
+    for (casadi_int i=0; i<n; ++i) {
+      if (nodes[i]) continue;
+      s.push_back(dep[2*i]);
+      while (!s.empty()) {
+        casadi_int t = s.back();
+        if (added[t]) {
+          s.pop_back();
+        } else if (!visited[t]) {
+          visited[t] = 1;
+          casadi_int d0 = dep[2*t], d1 = dep[2*t+1];
+          if (d1>=0 && need[d1]>need[d0]) std::swap(d0, d1);
+          if (d1>=0 && !added[d1]) s.push_back(d1);
+          if (d0>=0 && !added[d0]) s.push_back(d0);
+        } else {
+          s.pop_back();
+          added[t] = 1;
+          order.push_back(t);
+        }
+      }
+      // Output instruction
+      order.push_back(i);
+    }
+    casadi_assert_dev(order.size()==n);
+
+    // Keep the new ordering only if it does not need more work vector elements
+    casadi_int peak_before = peak_work(range(n));
+    casadi_int peak_after = peak_work(order);
+    if (verbose_) {
+      casadi_message("Reordered instructions: peak work array size " + str(peak_after)
+                     + " instead of " + str(peak_before));
+    }
+    if (peak_after <= peak_before) {
+      vector<SXNode*> nodes_old(n);
+      nodes.swap(nodes_old);
+      for (casadi_int i=0; i<n; ++i) nodes[i] = nodes_old[order[i]];
+    }
+  }
+
+  void SXFunction::init_fused() {
+    casadi_int n = algorithm_.size();
+
+    // Instruction that last wrote each element of the work vector
+    vector<casadi_int> def(worksize_, -1);
+
+    // Instructions producing the operands of each instruction, number of uses of each instruction
+    vector<casadi_int> dep1(n, -1), dep2(n, -1), nuse(n, 0);
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      casadi_int ndeps = casadi_math<double>::ndeps(e.op);
+      if (ndeps>=1) nuse[dep1[k] = def[e.i1]]++;
+      if (ndeps==2) nuse[dep2[k] = def[e.i2]]++;
+      if (e.op!=OP_OUTPUT) def[e.i0] = k;
+    }
+
+    // Candidate instructions, one per original instruction
+    vector<FusedAtomic> fused(n);
+    vector<bool> keep(n, true);
+
+    // Number of uses of each constant that have been folded into an immediate
+    vector<casadi_int> nfolded(n, 0);
+
+    fill(def.begin(), def.end(), -1);
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      FusedAtomic& f = fused[k];
+      f.op = e.op;
+      f.i0 = e.i0;
+      f.i3 = 0;
+      if (e.op==OP_CONST) {
+        f.i1 = f.i2 = 0;
+        f.d = e.d;
+      } else {
+        f.i1 = e.i1;
+        f.i2 = e.i2;
+        f.d = 0;
+      }
+
+      // Constant operands (first and second argument)
+      bool c1 = false, c2 = false;
+      if (casadi_math<double>::ndeps(e.op)==2) {
+        c1 = algorithm_[dep1[k]].op==OP_CONST;
+        c2 = algorithm_[dep2[k]].op==OP_CONST;
+      }
+
+      // Fold constant operand into an immediate
+      casadi_int c = -1;
+      switch (e.op) {
+      case OP_ADD:
+      case OP_MUL:
+        if (c2) {
+          c = dep2[k];
+        } else if (c1) {
+          c = dep1[k];
+          f.i1 = e.i2;
+        }
+        if (c>=0) f.op = e.op==OP_ADD ? FUSED_ADD_IMM : FUSED_MUL_IMM;
+        break;
+      case OP_SUB:
+      case OP_DIV:
+        if (c2) {
+          c = dep2[k];
+          f.op = e.op==OP_SUB ? FUSED_SUB_IMM : FUSED_DIV_IMM;
+        } else if (c1) {
+          c = dep1[k];
+          f.op = e.op==OP_SUB ? FUSED_RSUB_IMM : FUSED_RDIV_IMM;
+          f.i1 = e.i2;
+        }
+        break;
+      case OP_POW:
+      case OP_CONSTPOW:
+        if (c2) {
+          c = dep2[k];
+          f.op = FUSED_POW_IMM;
+        }
+        break;
+      default: break;
+      }
+      if (c>=0) {
+        f.d = algorithm_[c].d;
+        f.i2 = f.i1;
+        nfolded[c]++;
+      }
+
+      // Fuse a multiplication that is only used here into an addition or subtraction
+      if (f.op==OP_ADD || f.op==OP_SUB) {
+        for (casadi_int i=0; i<2; ++i) {
+          casadi_int p = i==0 ? dep1[k] : dep2[k];
+          // Multiplication, not fused itself and only used here
+          if (fused[p].op!=OP_MUL || !keep[p] || nuse[p]!=1) continue;
+          // Its operands must not have been overwritten since
+          const AlgEl& m = algorithm_[p];
+          if (def[m.i1]!=dep1[p] || def[m.i2]!=dep2[p]) continue;
+          f.i3 = i==0 ? e.i2 : e.i1;
+          f.i1 = m.i1;
+          f.i2 = m.i2;
+          if (f.op==OP_ADD) {
+            f.op = FUSED_MUL_ADD;
+          } else {
+            f.op = i==0 ? FUSED_MUL_SUB : FUSED_MUL_RSUB;
+          }
+          keep[p] = false;
+          break;
+        }
+      }
+
+      // Update the last write
+      if (e.op!=OP_OUTPUT) def[e.i0] = k;
+    }
+
+    // Drop constants that have been folded into all of their uses
+    for (casadi_int k=0; k<n; ++k) {
+      if (algorithm_[k].op==OP_CONST && nfolded[k]==nuse[k]) keep[k] = false;
+    }
+
+    // Renumber the work vector elements in order of first use, for locality
+    vector<int> place(worksize_, -1);
+    int nplace = 0;
+    auto renumber = [&](int& i) {
+      if (place[i]<0) place[i] = nplace++;
+      i = place[i];
+    };
+    fused_.clear();
+    for (casadi_int k=0; k<n; ++k) {
+      if (!keep[k]) continue;
+      FusedAtomic& f = fused[k];
+      switch (f.op) {
+      case OP_OUTPUT:
+        renumber(f.i1);
+        break;
+      case OP_INPUT:
+      case OP_CONST:
+      case OP_PARAMETER:
+        renumber(f.i0);
+        break;
+      case FUSED_MUL_ADD:
+      case FUSED_MUL_SUB:
+      case FUSED_MUL_RSUB:
+        renumber(f.i3);
+        // fall through
+      default:
+        renumber(f.i1);
+        renumber(f.i2);
+        renumber(f.i0);
+      }
+      fused_.push_back(f);
+    }
+
+    if (verbose_) {
+      casadi_message("Fused instructions: " + str(fused_.size()) + " instead of "
+        + str(algorithm_.size()));
+    }
+  }
+
   SX SXFunction::instructions_sx() const {
     std::vector<SXElem> ret(algorithm_.size(), casadi_limits<SXElem>::nan);
 
@@ -965,7 +1388,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 3);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -975,27 +1398,38 @@ namespace casadi {
     s.unpack("SXFunction::constants", constants_);
     s.unpack("SXFunction::default_in", default_in_);
 
+    // Algorithm, stored field by field
+    vector<int> op, i0, i1, i2;
+    s.unpack("SXFunction::ScalarAtomic::op", op);
+    s.unpack("SXFunction::ScalarAtomic::i0", i0);
+    s.unpack("SXFunction::ScalarAtomic::i1", i1);
+    s.unpack("SXFunction::ScalarAtomic::i2", i2);
+    casadi_assert_dev(op.size()==n_instructions && i0.size()==n_instructions
+                      && i1.size()==n_instructions && i2.size()==n_instructions);
     algorithm_.resize(n_instructions);
     for (casadi_int k=0;k<n_instructions;++k) {
       AlgEl& e = algorithm_[k];
-      s.unpack("SXFunction::ScalarAtomic::op", e.op);
-      s.unpack("SXFunction::ScalarAtomic::i0", e.i0);
-      s.unpack("SXFunction::ScalarAtomic::i1", e.i1);
-      s.unpack("SXFunction::ScalarAtomic::i2", e.i2);
+      e.op = op[k];
+      e.i0 = i0[k];
+      e.i1 = i1[k];
+      e.i2 = i2[k];
     }
 
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    reorder_instructions_ = false;
 
     s.unpack("SXFunction::live_variables", live_variables_);
+    s.unpack("SXFunction::fuse_instructions", fuse_instructions_);
+    if (fuse_instructions_) init_fused();
 
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 3);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1004,15 +1438,23 @@ namespace casadi {
     s.pack("SXFunction::constants", constants_);
     s.pack("SXFunction::default_in", default_in_);
 
-    // Loop over algorithm
-    for (const auto& e : algorithm_) {
-      s.pack("SXFunction::ScalarAtomic::op", e.op);
-      s.pack("SXFunction::ScalarAtomic::i0", e.i0);
-      s.pack("SXFunction::ScalarAtomic::i1", e.i1);
-      s.pack("SXFunction::ScalarAtomic::i2", e.i2);
+    // Algorithm, stored field by field for bulk writes
+    size_t n = algorithm_.size();
+    vector<int> op(n), i0(n), i1(n), i2(n);
+    for (size_t k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      op[k] = e.op;
+      i0[k] = e.i0;
+      i1[k] = e.i1;
+      i2[k] = e.i2;
     }
+    s.pack("SXFunction::ScalarAtomic::op", op);
+    s.pack("SXFunction::ScalarAtomic::i0", i0);
+    s.pack("SXFunction::ScalarAtomic::i1", i1);
+    s.pack("SXFunction::ScalarAtomic::i2", i2);
 
     s.pack("SXFunction::live_variables", live_variables_);
+    s.pack("SXFunction::fuse_instructions", fuse_instructions_);
 
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
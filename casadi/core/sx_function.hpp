@@ -41,6 +41,16 @@ namespace casadi {
     };
   };
 
+  /** \brief  An operation for the SXElem virtual machine, possibly fused
+   * The operator index is either a built-in operation or a superinstruction
+   * (see SXFunction::fuse_instructions_)
+   */
+  struct FusedAtomic {
+    int op;     /// Operator or superinstruction index
+    int i0, i1, i2, i3;
+    double d;
+  };
+
 /** \brief  Internal node class for SXFunction
     Do not use any internal class directly - always use the public Function
     \author Joel Andersson
@@ -62,6 +72,24 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Evaluate numerically, work vectors given */
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically for n points at once
+   *
+   * Inputs and outputs use the same layout as Map, i.e. n consecutive copies of the
+   * nonzeros of each input and output. The points are processed in blocks of batch_size,
+   * stored lane by lane in the work vector (of length sz_w_batch()), so that every
+   * instruction is dispatched once per block rather than once per point.
+   */
+  int eval_batch(const double** arg, double** res, double* w, casadi_int n) const;
+
+  /** \brief Can eval_batch be used in place of repeated calls to eval */
+  bool has_eval_batch() const;
+
+  /** \brief Length of the work vector needed by eval_batch */
+  size_t sz_w_batch() const { return worksize_*batch_size;}
+
+  /// Number of points evaluated simultaneously by eval_batch
+  static const casadi_int batch_size = 8;
+
   /** \brief  evaluate symbolically while also propagating directional derivatives */
   int eval_sx(const SXElem** arg, SXElem** res,
               casadi_int* iw, SXElem* w, void* mem) const override;
@@ -206,6 +234,9 @@ class CASADI_EXPORT SXFunction :
   /** \brief Generate code for the body of the C function */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Generate the batched entry point, evaluating blocks of points lane by lane */
+  void codegen_batch(CodeGenerator& g) const override;
+
   /** \brief  Propagate sparsity forward */
   int sp_forward(const bvec_t** arg, bvec_t** res,
                   casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -213,6 +244,9 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Propagate sparsity backwards */
   int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const override;
 
+  /** \brief  Can seeds be propagated concurrently, given separate work vectors? */
+  bool sp_thread_safe() const override { return true;}
+
   /** \brief Return Jacobian of all input elements with respect to all output elements */
   Function get_jacobian(const std::string& name,
                                    const std::vector<std::string>& inames,
@@ -238,9 +272,28 @@ class CASADI_EXPORT SXFunction :
   /// Live variables?
   bool live_variables_;
 
+  /// Reorder the instructions to shorten the live ranges?
+  bool reorder_instructions_;
+
+  /// Reorder a depth-first sorted list of nodes to shorten the live ranges
+  void reorder_nodes(std::vector<SXNode*>& nodes) const;
+
+  /// Fuse instruction sequences into superinstructions for numerical evaluation?
+  bool fuse_instructions_;
+
+  /// Instructions used for numerical evaluation when fuse_instructions_ is set
+  std::vector<FusedAtomic> fused_;
+
+  /// Generate fused_ from algorithm_
+  void init_fused();
+
 protected:
   /** \brief Deserializing constructor */
   explicit SXFunction(DeserializingStream& s);
+
+  /** \brief Evaluate N consecutive points, starting at point offset */
+  template<casadi_int N>
+  void eval_lanes(const double** arg, double** res, double* w, casadi_int offset) const;
 };
 
 
@@ -29,9 +29,19 @@
 #include "binary_sx.hpp"
 #include "constant_sx.hpp"
 #include "symbolic_sx.hpp"
+#include "sparsity.hpp"
 
 #include <limits>
 #include <stack>
+#include <unordered_map>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
 
 using namespace std;
 namespace casadi {
@@ -161,6 +171,8 @@ namespace casadi {
       delete n;
       return;
     }
+    // Unregister before the dependencies are released
+    n->hash_cons_release();
     // Stack of expressions to be deleted
     std::stack<SXNode*> deletion_stack;
     // Add the node to the deletion stack
@@ -182,6 +194,8 @@ namespace casadi {
             // Delete straight away if not binary
             delete n2;
           } else {
+            // Unregister before the dependencies are released
+            n2->hash_cons_release();
             // Add to deletion stack
             deletion_stack.push(n2);
             added_to_stack = true;
@@ -198,6 +212,84 @@ namespace casadi {
 
   casadi_int SXNode::eq_depth_ = 1;
 
+  /// \cond INTERNAL
+  // Key of the hash-consing table
+  struct HashConsKey {
+    casadi_int op;
+    const SXNode* dep0;
+    const SXNode* dep1;
+    bool operator==(const HashConsKey& k) const {
+      return op==k.op && dep0==k.dep0 && dep1==k.dep1;
+    }
+  };
+
+  struct HashConsHash {
+    size_t operator()(const HashConsKey& k) const {
+      size_t seed = 0;
+      hash_combine(seed, k.op);
+      hash_combine(seed, reinterpret_cast<size_t>(k.dep0));
+      hash_combine(seed, reinterpret_cast<size_t>(k.dep1));
+      return seed;
+    }
+  };
+  /// \endcond
+
+  typedef std::unordered_map<HashConsKey, SXNode*, HashConsHash> HashConsTable;
+
+  // Never destroyed, since nodes in static expressions may outlive it
+  static HashConsTable& hash_cons_table() {
+    static HashConsTable* table = new HashConsTable();
+    return *table;
+  }
+
+#ifdef CASADI_WITH_THREAD
+  static std::mutex hash_cons_mtx;
+#endif // CASADI_WITH_THREAD
+
+  casadi_int SXNode::hash_cons_lookups_ = 0;
+  casadi_int SXNode::hash_cons_hits_ = 0;
+
+  bool SXNode::hash_cons_find(casadi_int op, const SXNode* dep0, const SXNode* dep1,
+                              bool commutative, SXElem& ret) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(hash_cons_mtx);
+#endif // CASADI_WITH_THREAD
+    hash_cons_lookups_++;
+    HashConsTable& table = hash_cons_table();
+    auto it = table.find(HashConsKey{op, dep0, dep1});
+    // Commutative operations match with the arguments swapped
+    if (it==table.end() && commutative && dep0!=dep1) {
+      it = table.find(HashConsKey{op, dep1, dep0});
+    }
+    if (it==table.end()) return false;
+    // A node without owners is being deleted and must not be handed out
+    if (it->second->count==0) return false;
+    hash_cons_hits_++;
+    // Take the reference before the lock is released
+    ret = SXElem::create(it->second);
+    return true;
+  }
+
+  void SXNode::hash_cons_insert(SXNode* n, casadi_int op, const SXNode* dep0,
+                                const SXNode* dep1) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(hash_cons_mtx);
+#endif // CASADI_WITH_THREAD
+    // Replaces the entry of a node that is being deleted, if any
+    hash_cons_table()[HashConsKey{op, dep0, dep1}] = n;
+  }
+
+  void SXNode::hash_cons_erase(const SXNode* n, casadi_int op, const SXNode* dep0,
+                               const SXNode* dep1) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(hash_cons_mtx);
+#endif // CASADI_WITH_THREAD
+    HashConsTable& table = hash_cons_table();
+    auto it = table.find(HashConsKey{op, dep0, dep1});
+    // The entry may already refer to a node created in the meantime
+    if (it!=table.end() && it->second==n) table.erase(it);
+  }
+
   void SXNode::serialize_node(SerializingStream& s) const {
     casadi_error("'serialize_node' not defined for class " + class_name());
   }
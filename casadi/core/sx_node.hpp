@@ -121,6 +121,26 @@ namespace casadi {
     /** \brief Non-recursive delete */
     static void safe_delete(SXNode* n);
 
+    ///@{
+    /** \brief Hash-consing table of operation nodes, keyed on (op, dep0, dep1)
+        Used when GlobalOptions::hash_consing is set. For unary operations, dep1 is null.
+        A successful lookup returns a new reference to the node in ret.
+    */
+    static bool hash_cons_find(casadi_int op, const SXNode* dep0, const SXNode* dep1,
+                               bool commutative, SXElem& ret);
+    static void hash_cons_insert(SXNode* n, casadi_int op, const SXNode* dep0,
+                                 const SXNode* dep1);
+    static void hash_cons_erase(const SXNode* n, casadi_int op, const SXNode* dep0,
+                                const SXNode* dep1);
+    ///@}
+
+    /** \brief Remove the node from the hash-consing table
+        Must be called before the dependencies are released */
+    virtual void hash_cons_release() {}
+
+    /// Hash-consing statistics, since the last reset
+    static casadi_int hash_cons_lookups_, hash_cons_hits_;
+
     // Depth when checking equalities
     static casadi_int eq_depth_;
 
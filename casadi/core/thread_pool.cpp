@@ -0,0 +1,185 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "global_options.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace casadi {
+
+  ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+#ifndef CASADI_WITH_THREAD
+
+  ThreadPool::ThreadPool() {
+  }
+
+  ThreadPool::~ThreadPool() {
+  }
+
+  casadi_int ThreadPool::size() const {
+    return 1;
+  }
+
+  void ThreadPool::run(casadi_int n, casadi_int nw, const Task& task) {
+    for (casadi_int i=0; i<n; ++i) task(i, 0);
+  }
+
+#else // CASADI_WITH_THREAD
+
+  namespace {
+    /// Set while the current thread executes tasks of the pool
+    thread_local bool inside_pool = false;
+
+    /// Marks the current thread as being inside the pool during its lifetime
+    struct InsidePool {
+      bool prev;
+      InsidePool() : prev(inside_pool) { inside_pool = true;}
+      ~InsidePool() { inside_pool = prev;}
+    };
+  } // namespace
+
+  ThreadPool::ThreadPool() : task_(nullptr), n_(0), nw_(0), chunk_(1), generation_(0),
+      active_(0), next_(0), stop_(false) {
+  }
+
+  ThreadPool::~ThreadPool() {
+    resize(1);
+  }
+
+  casadi_int ThreadPool::size() const {
+    casadi_int sz = GlobalOptions::num_threads;
+    if (sz<=0) sz = thread::hardware_concurrency();
+    return max(sz, casadi_int(1));
+  }
+
+  void ThreadPool::resize(casadi_int sz) {
+    if (static_cast<casadi_int>(threads_.size())+1==sz) return;
+    // Stop all workers
+    if (!threads_.empty()) {
+      {
+        lock_guard<mutex> lock(mtx_);
+        stop_ = true;
+      }
+      cv_start_.notify_all();
+      for (auto&& th : threads_) th.join();
+      threads_.clear();
+      stop_ = false;
+    }
+    // Start new workers, the calling thread acts as worker 0
+    for (casadi_int w=1; w<sz; ++w) {
+      threads_.emplace_back([this, w]() { worker(w);});
+    }
+  }
+
+  void ThreadPool::run(casadi_int n, casadi_int nw, const Task& task) {
+    // Serial evaluation for nested calls, which must not touch busy_: the
+    // calling thread of the outer job may already own it
+    nw = min(nw, n);
+    if (inside_pool || nw<=1) {
+      for (casadi_int i=0; i<n; ++i) task(i, 0);
+      return;
+    }
+
+    // Serial evaluation if the pool is in use by another thread
+    unique_lock<mutex> busy(busy_, try_to_lock);
+    if (!busy.owns_lock()) {
+      for (casadi_int i=0; i<n; ++i) task(i, 0);
+      return;
+    }
+
+    // Make sure that the number of workers is up-to-date
+    resize(size());
+    nw = min(nw, static_cast<casadi_int>(threads_.size())+1);
+
+    // Publish the job
+    {
+      lock_guard<mutex> lock(mtx_);
+      task_ = &task;
+      n_ = n;
+      nw_ = nw;
+      // A few chunks per worker for load balancing
+      chunk_ = max(n / (4*nw), casadi_int(1));
+      next_ = 0;
+      error_ = nullptr;
+      active_ = nw;
+      generation_++;
+    }
+    cv_start_.notify_all();
+
+    // Take part in the job
+    work(0);
+
+    // Wait for the other workers
+    unique_lock<mutex> lock(mtx_);
+    cv_done_.wait(lock, [this]() { return active_==0;});
+    task_ = nullptr;
+    if (error_) rethrow_exception(error_);
+  }
+
+  void ThreadPool::worker(casadi_int w) {
+    casadi_int generation = 0;
+    while (true) {
+      {
+        unique_lock<mutex> lock(mtx_);
+        cv_start_.wait(lock, [this, generation]() { return stop_ || generation_!=generation;});
+        if (stop_) return;
+        generation = generation_;
+        // Not needed for this job
+        if (w>=nw_) continue;
+      }
+      work(w);
+    }
+  }
+
+  void ThreadPool::work(casadi_int w) {
+    InsidePool inside;
+    try {
+      while (true) {
+        casadi_int i0 = next_.fetch_add(chunk_);
+        if (i0>=n_) break;
+        casadi_int i1 = min(i0+chunk_, n_);
+        for (casadi_int i=i0; i<i1; ++i) (*task_)(i, w);
+      }
+    } catch (...) {
+      lock_guard<mutex> lock(mtx_);
+      if (!error_) error_ = current_exception();
+      // Skip the remaining tasks
+      next_ = n_;
+    }
+    // Signal completion
+    lock_guard<mutex> lock(mtx_);
+    if (--active_==0) cv_done_.notify_one();
+  }
+
+#endif // CASADI_WITH_THREAD
+
+} // namespace casadi
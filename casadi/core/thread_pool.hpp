@@ -0,0 +1,135 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <functional>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#include <atomic>
+#include <exception>
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Process-wide pool of persistent worker threads
+
+      The number of workers (including the calling thread) is set with
+      GlobalOptions::setNumThreads. Tasks are handed out in chunks from a shared
+      counter, so that idle workers pick up the remaining work of busy ones.
+      Without WITH_THREAD, or when the pool is already in use (e.g. nested calls),
+      the tasks are executed serially by the calling thread.
+
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Task: index of the task and index of the worker executing it
+    typedef std::function<void(casadi_int, casadi_int)> Task;
+
+    /// Access the process-wide instance
+    static ThreadPool& instance();
+
+    /// Destructor
+    ~ThreadPool();
+
+    /// Number of workers, including the calling thread
+    casadi_int size() const;
+
+    /** \brief Execute task(i, w) for i = 0, ..., n-1
+     *
+     * At most nw workers are used and the worker index w is guaranteed to
+     * be smaller than nw.
+     */
+    void run(casadi_int n, casadi_int nw, const Task& task);
+
+  private:
+    /// Constructor (use instance() instead)
+    ThreadPool();
+
+    /// No copies
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+#ifdef CASADI_WITH_THREAD
+    /// Start or stop workers to reach a given size
+    void resize(casadi_int sz);
+
+    /// Work loop of worker w
+    void worker(casadi_int w);
+
+    /// Execute chunks of the current job as worker w
+    void work(casadi_int w);
+
+    /// Worker threads
+    std::vector<std::thread> threads_;
+
+    /// Held during a job, serializes concurrent callers
+    std::mutex busy_;
+
+    /// Protects the job description below
+    std::mutex mtx_;
+
+    /// Signals new jobs to the workers and completion to the caller
+    std::condition_variable cv_start_, cv_done_;
+
+    /// Current job
+    const Task* task_;
+    casadi_int n_, nw_, chunk_;
+
+    /// Job counter, incremented for every new job
+    casadi_int generation_;
+
+    /// Number of workers still active in the current job
+    casadi_int active_;
+
+    /// Next task to be handed out
+    std::atomic<casadi_int> next_;
+
+    /// First exception raised in the current job
+    std::exception_ptr error_;
+
+    /// Terminate workers
+    bool stop_;
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
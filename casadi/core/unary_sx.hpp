@@ -28,6 +28,7 @@
 
 #include "sx_node.hpp"
 #include "serializing_stream.hpp"
+#include "global_options.hpp"
 
 /// \cond INTERNAL
 
@@ -41,7 +42,7 @@ class UnarySX : public SXNode {
   private:
 
     /** \brief  Constructor is private, use "create" below */
-    UnarySX(unsigned char op, const SXElem& dep) : op_(op), dep_(dep) {}
+    UnarySX(unsigned char op, const SXElem& dep) : op_(op), hashed_(false), dep_(dep) {}
 
   public:
 
@@ -53,6 +54,14 @@ class UnarySX : public SXNode {
         double ret_val;
         casadi_math<double>::fun(op, dep_val, dep_val, ret_val);
         return ret_val;
+      } else if (GlobalOptions::hash_consing) {
+        // Reuse an identical expression, if any
+        SXElem ret;
+        if (hash_cons_find(op, dep.get(), nullptr, false, ret)) return ret;
+        UnarySX* r = new UnarySX(op, dep);
+        r->hashed_ = true;
+        hash_cons_insert(r, op, dep.get(), nullptr);
+        return SXElem::create(r);
       } else {
         // Expression containing free variables
         return SXElem::create(new UnarySX(op, dep));
@@ -61,9 +70,17 @@ class UnarySX : public SXNode {
 
     /** \brief Destructor */
     ~UnarySX() override {
+      hash_cons_release();
       safe_delete(dep_.assignNoDelete(casadi_limits<SXElem>::nan));
     }
 
+    void hash_cons_release() override {
+      if (hashed_) {
+        hashed_ = false;
+        hash_cons_erase(this, op_, dep_.get(), nullptr);
+      }
+    }
+
     // Class name
     std::string class_name() const override {return "UnarySX";}
 
@@ -95,6 +112,9 @@ class UnarySX : public SXNode {
     /** \brief  The binary operation as an 1 byte integer (allows 256 values) */
     unsigned char op_;
 
+    /** \brief  Registered in the hash-consing table */
+    bool hashed_;
+
     /** \brief  The dependencies of the node */
     SXElem dep_;
 
@@ -59,7 +59,7 @@ namespace casadi {
   }
 
   const Options LapackLu::options_
-  = {{&FunctionInternal::options_},
+  = {{&LinsolInternal::options_},
      {{"equilibration",
        {OT_BOOL,
         "Equilibrate the matrix"}},
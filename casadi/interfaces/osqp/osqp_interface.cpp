@@ -232,27 +232,28 @@ namespace casadi {
     ret = osqp_update_bounds(m->work, w, w+nx_+na_);
     casadi_assert(ret==0, "Problem in osqp_update_bounds");
 
-    // Project Hessian
-    casadi_tri_project(arg[CONIC_H], H_, w, false);
-
-    // Get contraint matrix
-    const casadi_int* colind = A_.colind();
-    double* A = w + nnzHupp_;
-    // Get constraint matrix
-    casadi_int offset = 0;
-    // Loop over columns
-    for (casadi_int i=0; i<nx_; ++i) {
-      A[offset] = 1;
-      offset++;
-      casadi_int n = colind[i+1]-colind[i];
-      casadi_copy(a+colind[i], n, A+offset);
-      offset+= n;
-    }
-
-    // Pass Hessian and constraint matrices
-    ret = osqp_update_P_A(m->work, w, nullptr, nnzHupp_, A, nullptr, nnzA_);
-    casadi_assert(ret==0, "Problem in osqp_update_P_A");
+    // Pass Hessian and constraint matrices, unless the factorization can be reused
+    if (!reuse_factorization(m, h, a)) {
+      // Project Hessian
+      casadi_tri_project(arg[CONIC_H], H_, w, false);
+
+      // Get contraint matrix
+      const casadi_int* colind = A_.colind();
+      double* A = w + nnzHupp_;
+      // Get constraint matrix
+      casadi_int offset = 0;
+      // Loop over columns
+      for (casadi_int i=0; i<nx_; ++i) {
+        A[offset] = 1;
+        offset++;
+        casadi_int n = colind[i+1]-colind[i];
+        casadi_copy(a+colind[i], n, A+offset);
+        offset+= n;
+      }
 
+      ret = osqp_update_P_A(m->work, w, nullptr, nnzHupp_, A, nullptr, nnzA_);
+      casadi_assert(ret==0, "Problem in osqp_update_P_A");
+    }
 
     if (warm_start_primal_) {
       ret = osqp_warm_start_x(m->work, arg[CONIC_X0]);
@@ -317,6 +317,7 @@ namespace casadi {
     alloc_w(na_, true); // lba
     alloc_w(na_, true); // uba
     alloc_w(nx_+na_, true); // dual
+    alloc_w(nx_+na_, true); // initial guess for dual
   }
 
   int QpoasesInterface::init_mem(void* mem) const {
@@ -324,6 +325,12 @@ namespace casadi {
     auto m = static_cast<QpoasesMemory*>(mem);
     m->called_once = false;
 
+    // qpOASES keeps pointers to the matrices, which must outlive a call to be reused
+    if (reuse_factorization_) {
+      m->h_keep.resize(sparse_ ? H_.nnz() : nx_*nx_);
+      m->a_keep.resize(sparse_ ? A_.nnz() : nx_*na_);
+    }
+
     // Linear solver, if any
     m->linsol_plugin = linsol_plugin_;
 
@@ -378,49 +385,76 @@ namespace casadi {
     double* ubA=w; w += na_;
     casadi_copy(arg[CONIC_UBA], na_, ubA);
 
+    // Initial guess for a cold start. The working set is given by the nonzero
+    // multipliers, if any, otherwise qpOASES obtains it from the primal guess
+    double* y0=w; w += nx_+na_;
+    casadi_copy(arg[CONIC_LAM_X0], nx_, y0);
+    casadi_copy(arg[CONIC_LAM_A0], na_, y0+nx_);
+    casadi_scal(nx_+na_, -1., y0);
+    const double* x_guess = arg[CONIC_X0];
+    const double* y_guess = casadi_norm_inf(nx_+na_, y0) > 0 ? y0 : nullptr;
+
+    // Reuse the factorization of the previous call?
+    bool reuse = reuse_factorization(m, arg[CONIC_H], arg[CONIC_A]) && m->called_once;
+
     // Return flag
     casadi_int flag;
 
     // Sparse or dense mode?
     if (sparse_) {
-      // Get quadratic term
-      copy_vector(H_.colind(), m->h_colind);
-      copy_vector(H_.row(), m->h_row);
       double* h=w; w += H_.nnz();
-      casadi_copy(arg[CONIC_H], H_.nnz(), h);
-      delete m->h;
-      m->h = new qpOASES::SymSparseMat(H_.size1(), H_.size2(),
-        get_ptr(m->h_row), get_ptr(m->h_colind), h);
-      m->h->createDiagInfo();
-
-      // Get linear term
-      copy_vector(A_.colind(), m->a_colind);
-      copy_vector(A_.row(), m->a_row);
       double* a=w; w += A_.nnz();
-      casadi_copy(arg[CONIC_A], A_.nnz(), a);
-      delete m->a;
-      m->a = new qpOASES::SparseMatrix(A_.size1(), A_.size2(),
-        get_ptr(m->a_row), get_ptr(m->a_colind), a);
+      if (reuse_factorization_) {
+        h = get_ptr(m->h_keep);
+        a = get_ptr(m->a_keep);
+      }
+      if (!reuse) {
+        // Get quadratic term
+        copy_vector(H_.colind(), m->h_colind);
+        copy_vector(H_.row(), m->h_row);
+        casadi_copy(arg[CONIC_H], H_.nnz(), h);
+        delete m->h;
+        m->h = new qpOASES::SymSparseMat(H_.size1(), H_.size2(),
+          get_ptr(m->h_row), get_ptr(m->h_colind), h);
+        m->h->createDiagInfo();
+
+        // Get linear term
+        copy_vector(A_.colind(), m->a_colind);
+        copy_vector(A_.row(), m->a_row);
+        casadi_copy(arg[CONIC_A], A_.nnz(), a);
+        delete m->a;
+        m->a = new qpOASES::SparseMatrix(A_.size1(), A_.size2(),
+          get_ptr(m->a_row), get_ptr(m->a_colind), a);
+      }
 
       m->fstats.at("preprocessing").toc();
       m->fstats.at("solver").tic();
 
       // Solve sparse
-      if (m->called_once) {
+      if (reuse) {
+        flag = m->sqp->hotstart(g, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+      } else if (m->called_once) {
         flag = m->sqp->hotstart(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
       } else {
-        flag = m->sqp->init(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+        flag = m->sqp->init(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr,
+                            x_guess, y_guess);
       }
       m->fstats.at("solver").toc();
 
     } else {
-      // Get quadratic term
       double* h=w; w += nx_*nx_;
-      casadi_densify(arg[CONIC_H], H_, h, false);
+      double* a=w; w += nx_*na_;
+      if (reuse_factorization_) {
+        h = get_ptr(m->h_keep);
+        a = get_ptr(m->a_keep);
+      }
+      if (!reuse) {
+        // Get quadratic term
+        casadi_densify(arg[CONIC_H], H_, h, false);
 
-      // Get linear term
-      double* a = w; w += nx_*na_;
-      casadi_densify(arg[CONIC_A], A_, a, true);
+        // Get linear term
+        casadi_densify(arg[CONIC_A], A_, a, true);
+      }
 
       m->fstats.at("preprocessing").toc();
       m->fstats.at("solver").tic();
@@ -430,15 +464,18 @@ namespace casadi {
           // Broken?
           //flag = m->qp->hotstart(g, lb, ub, nWSR, cputime_ptr);
           m->qp->reset();
-          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr);
+          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr, x_guess, y_guess);
         } else {
-          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr);
+          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr, x_guess, y_guess);
         }
       } else {
-        if (m->called_once) {
+        if (reuse) {
+          flag = m->sqp->hotstart(g, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+        } else if (m->called_once) {
           flag = m->sqp->hotstart(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
         } else {
-          flag = m->sqp->init(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+          flag = m->sqp->init(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr,
+                              x_guess, y_guess);
         }
       }
       m->fstats.at("solver").toc();
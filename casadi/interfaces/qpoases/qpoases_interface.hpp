@@ -75,6 +75,9 @@ namespace casadi {
     // Nonzero entries
     std::vector<double> nz;
 
+    // QP matrices kept between calls, if reusing the factorization
+    std::vector<double> h_keep, a_keep;
+
     int return_status;
 
     /// Constructor
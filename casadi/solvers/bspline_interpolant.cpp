@@ -25,6 +25,7 @@
 
 #include "bspline_interpolant.hpp"
 #include "casadi/core/bspline.hpp"
+#include "casadi/core/mx_function.hpp"
 
 using namespace std;
 namespace casadi {
@@ -190,6 +191,19 @@ namespace casadi {
     return S_->get_jacobian(name, inames, onames, opts);
   }
 
+  Function BSplineInterpolant::get_map(const std::string& name, casadi_int n) const {
+    // Parametric coefficients may differ between instances
+    if (has_parametric_values() || !S_.is_a("MXFunction")) return Function();
+    const MX& e = S_.get<MXFunction>()->out_.at(0);
+    if (!e.is_op(OP_BSPLINE)) return Function();
+
+    // Same spline node, with the points as columns of its argument
+    MX x = MX::sym("x", ndim_, n);
+    std::vector<MX> res(1);
+    e->eval_mx({x}, res);
+    return Function(name, {x}, res, name_in_, name_out_);
+  }
+
   BSplineInterpolant::BSplineInterpolant(DeserializingStream& s) : Interpolant(s) {
     s.version("BSplineInterpolant", 1);
     s.unpack("BSplineInterpolant::s", S_);
@@ -92,6 +92,9 @@ namespace casadi {
                                       const Dict& opts) const override;
     ///@}
 
+    /** \brief Serial map evaluating all points in one batched BSpline node */
+    Function get_map(const std::string& name, casadi_int n) const override;
+
     /** \brief Is codegen supported? */
     bool has_codegen() const override { return true;}
 
@@ -52,7 +52,9 @@ namespace casadi {
        {OT_STRINGVECTOR,
         "Sets, for each grid dimenion, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; "
-        "'exact' uses floored division (only for uniform grids)."}}
+        "'exact' uses floored division (only for uniform grids); "
+        "'binary' uses a binary search; "
+        "'bucket' uses a precomputed table of equal-width buckets (only for fixed grids)."}}
      }
   };
 
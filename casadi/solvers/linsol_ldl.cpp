@@ -55,13 +55,21 @@ namespace casadi {
   }
 
   const Options LinsolLdl::options_
-  = {{&ProtoFunction::options_},
+  = {{&LinsolInternal::options_},
      {{"incomplete",
       {OT_BOOL,
        "Incomplete factorization, without any fill-in"}},
       {"preordering",
        {OT_BOOL,
-       "Approximate minimal degree (AMD) preordering"}}
+       "Approximate minimal degree (AMD) preordering"}},
+      {"supernodal",
+       {OT_BOOL,
+       "Supernodal factorization: columns with identical structure are "
+       "factorized together using dense kernels. Not with incomplete."}},
+      {"parallel_solve_nnz",
+       {OT_INT,
+       "Use multithreaded, level-scheduled triangular solves when the factor "
+       "has at least this many nonzeros. Negative: never [default 100000]"}}
      }
   };
 
@@ -72,6 +80,8 @@ namespace casadi {
     // Default options
     incomplete_ = false;
     amd_ = true;
+    supernodal_ = false;
+    parallel_solve_nnz_ = 100000;
 
     // Read user options
     for (auto&& op : opts) {
@@ -79,9 +89,16 @@ namespace casadi {
         incomplete_ = op.second;
       } else if (op.first=="amd") {
         amd_ = op.second;
+      } else if (op.first=="supernodal") {
+        supernodal_ = op.second;
+      } else if (op.first=="parallel_solve_nnz") {
+        parallel_solve_nnz_ = op.second;
       }
     }
 
+    casadi_assert(!(incomplete_ && supernodal_),
+      "Options 'incomplete' and 'supernodal' are mutually exclusive");
+
     // Symbolic factorization
     if (incomplete_) {
       if (amd_) {
@@ -94,10 +111,34 @@ namespace casadi {
         p_ = range(sp_.size1());  // no reordering
         sp_Lt_ = triu(sp_, false);  // no fill-in
       }
+    } else if (supernodal_) {
+      // Supernodal LDL^T
+      sp_Lt_ = sp_.ldl_super(p_, sp_super_, amd_);
     } else {
       // Regular LDL^T
       sp_Lt_ = sp_.ldl(p_, amd_);
     }
+    sz_super_ = supernodal_ ? panel_size(sp_super_) : 0;
+    init_levels();
+  }
+
+  void LinsolLdl::init_levels() {
+    parallel_solve_ = parallel_solve_nnz_>=0 && sp_Lt_.nnz()>=parallel_solve_nnz_;
+    if (parallel_solve_) {
+      lev_l_ = LevelSchedule(sp_Lt_, true);
+      lev_lt_ = LevelSchedule(sp_Lt_, false);
+    }
+  }
+
+  casadi_int LinsolLdl::panel_size(const Sparsity& sp_super) {
+    casadi_int n = sp_super.size1(), ns = sp_super.size2();
+    const casadi_int *colind = sp_super.colind(), *row = sp_super.row();
+    casadi_int sz = 0;
+    for (casadi_int s=0; s<ns; ++s) {
+      casadi_int nc = (s+1<ns ? row[colind[s+1]] : n) - row[colind[s]];
+      sz += nc*(colind[s+1]-colind[s]);
+    }
+    return sz;
   }
 
   int LinsolLdl::init_mem(void* mem) const {
@@ -108,7 +149,8 @@ namespace casadi {
     casadi_int nrow = this->nrow();
     m->d.resize(nrow);
     m->l.resize(sp_Lt_.nnz());
-    m->w.resize(nrow);
+    m->w.resize(std::max(nrow + sz_super_, 8*nrow));
+    if (supernodal_) m->iw.resize(3*nrow+1);
 
     return 0;
   }
@@ -119,7 +161,12 @@ namespace casadi {
 
   int LinsolLdl::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (supernodal_) {
+      casadi_ldl_super(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_),
+                       sp_super_, get_ptr(m->w), get_ptr(m->iw));
+    } else {
+      casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    }
     for (double d : m->d) {
       if (d==0) casadi_warning("LDL factorization has zeros in D");
     }
@@ -128,7 +175,28 @@ namespace casadi {
 
   int LinsolLdl::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (!parallel_solve_) {
+      casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+      return 0;
+    }
+    // As casadi_ldl_solve, with level-scheduled solves for L and L'
+    casadi_int n = nrow(), nb;
+    double* w = get_ptr(m->w);
+    for (; nrhs>0; nrhs-=nb) {
+      nb = std::min(nrhs, casadi_int(8));
+      for (casadi_int i=0; i<n; ++i) {
+        for (casadi_int j=0; j<nb; ++j) w[nb*i+j] = x[n*j+p_[i]];
+      }
+      lev_l_.solve(get_ptr(m->l), w, nb);
+      for (casadi_int i=0; i<n; ++i) {
+        for (casadi_int j=0; j<nb; ++j) w[nb*i+j] /= m->d[i];
+      }
+      lev_lt_.solve(get_ptr(m->l), w, nb);
+      for (casadi_int i=0; i<n; ++i) {
+        for (casadi_int j=0; j<nb; ++j) x[n*j+p_[i]] = w[nb*i+j];
+      }
+      x += n*nb;
+    }
     return 0;
   }
 
@@ -162,10 +230,15 @@ namespace casadi {
     g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
     g << "casadi_real lt[" << sp_Lt_.nnz() << "], "
          "d[" << nrow() << "], "
-         "w[" << nrow() << "];\n";
+         "w[" << std::max(nrow() + sz_super_, nrow()*std::min(nrhs, casadi_int(8))) << "];\n";
 
     // Factorize
-    g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    if (supernodal_) {
+      g << "casadi_int iw[" << 3*nrow()+1 << "];\n";
+      g << g.ldl_super(sp, A, sp_Lt, "lt", "d", p, g.sparsity(sp_super_), "w", "iw") << "\n";
+    } else {
+      g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    }
 
     // Solve
     g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
@@ -175,16 +248,28 @@ namespace casadi {
   }
 
   LinsolLdl::LinsolLdl(DeserializingStream& s) : LinsolInternal(s) {
-    s.version("LinsolLdl", 1);
+    s.version("LinsolLdl", 3);
     s.unpack("LinsolLdl::p", p_);
     s.unpack("LinsolLdl::sp_Lt", sp_Lt_);
+    s.unpack("LinsolLdl::supernodal", supernodal_);
+    if (supernodal_) {
+      s.unpack("LinsolLdl::sp_super", sp_super_);
+      sz_super_ = panel_size(sp_super_);
+    } else {
+      sz_super_ = 0;
+    }
+    s.unpack("LinsolLdl::parallel_solve_nnz", parallel_solve_nnz_);
+    init_levels();
   }
 
   void LinsolLdl::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolLdl", 1);
+    s.version("LinsolLdl", 3);
     s.pack("LinsolLdl::p", p_);
     s.pack("LinsolLdl::sp_Lt", sp_Lt_);
+    s.pack("LinsolLdl::supernodal", supernodal_);
+    if (supernodal_) s.pack("LinsolLdl::sp_super", sp_super_);
+    s.pack("LinsolLdl::parallel_solve_nnz", parallel_solve_nnz_);
   }
 
 } // namespace casadi
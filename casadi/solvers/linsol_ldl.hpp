@@ -34,11 +34,13 @@
 
 /// \cond INTERNAL
 #include "casadi/core/linsol_internal.hpp"
+#include "casadi/core/level_schedule.hpp"
 #include <casadi/solvers/casadi_linsol_ldl_export.h>
 
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<double> l, d, w;
+    std::vector<casadi_int> iw;
   };
 
   /** \brief \pluginbrief{LinsolInternal,ldl}
@@ -109,11 +111,26 @@ namespace casadi {
     std::vector<casadi_int> p_;
     Sparsity sp_Lt_;
 
+    // Supernodes, size of the dense panels
+    Sparsity sp_super_;
+    casadi_int sz_super_;
+
     ///@{
     // Options
-    bool incomplete_, amd_;
+    bool incomplete_, amd_, supernodal_;
+    casadi_int parallel_solve_nnz_;
     ///@}
 
+    // Level schedules for multithreaded solves with L and L'
+    bool parallel_solve_;
+    LevelSchedule lev_l_, lev_lt_;
+
+    // Analyse the factor pattern for multithreaded solves
+    void init_levels();
+
+    // Total size of the dense panels of the supernodes
+    static casadi_int panel_size(const Sparsity& sp_super);
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
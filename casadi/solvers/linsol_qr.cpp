@@ -58,7 +58,11 @@ namespace casadi {
   = {{&LinsolInternal::options_},
      {{"eps",
        {OT_DOUBLE,
-        "Minimum R entry before singularity is declared [1e-12]"}}
+        "Minimum R entry before singularity is declared [1e-12]"}},
+      {"parallel_solve_nnz",
+       {OT_INT,
+        "Use multithreaded, level-scheduled triangular solves when R "
+        "has at least this many nonzeros. Negative: never [default 100000]"}}
      }
   };
 
@@ -68,14 +72,26 @@ namespace casadi {
 
     // Read options
     eps_ = 1e-12;
+    parallel_solve_nnz_ = 100000;
     for (auto&& op : opts) {
       if (op.first=="eps") {
         eps_ = op.second;
+      } else if (op.first=="parallel_solve_nnz") {
+        parallel_solve_nnz_ = op.second;
       }
     }
 
     // Symbolic factorization
     sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
+    init_levels();
+  }
+
+  void LinsolQr::init_levels() {
+    parallel_solve_ = parallel_solve_nnz_>=0 && sp_r_.nnz()>=parallel_solve_nnz_;
+    if (parallel_solve_) {
+      lev_rt_ = LevelSchedule(sp_r_, true);
+      lev_r_ = LevelSchedule(sp_r_, false);
+    }
   }
 
   int LinsolQr::init_mem(void* mem) const {
@@ -86,7 +102,7 @@ namespace casadi {
     m->v.resize(sp_v_.nnz());
     m->r.resize(sp_r_.nnz());
     m->beta.resize(ncol());
-    m->w.resize(nrow() + ncol());
+    m->w.resize(std::max(nrow() + ncol(), 8*std::max(ncol(), sp_v_.size1())));
     return 0;
   }
 
@@ -120,9 +136,39 @@ namespace casadi {
 
   int LinsolQr::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolQrMemory*>(mem);
-    casadi_qr_solve(x, nrhs, tr,
-                    sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-                    get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    if (!parallel_solve_) {
+      casadi_qr_solve(x, nrhs, tr,
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+      return 0;
+    }
+    // As casadi_qr_solve, with level-scheduled solves for R' and R
+    casadi_int nrow_ext = sp_v_.size1(), ncol = this->ncol(), nb;
+    double* w = get_ptr(m->w);
+    for (; nrhs>0; nrhs-=nb) {
+      nb = std::min(nrhs, casadi_int(8));
+      if (tr) {
+        for (casadi_int c=0; c<ncol; ++c) {
+          for (casadi_int j=0; j<nb; ++j) w[nb*c+j] = x[ncol*j+pc_[c]];
+        }
+        lev_rt_.solve(get_ptr(m->r), w, nb);
+        casadi_qr_mv_blk(sp_v_, get_ptr(m->v), get_ptr(m->beta), w, 0, nb);
+        for (casadi_int c=0; c<ncol; ++c) {
+          for (casadi_int j=0; j<nb; ++j) x[ncol*j+c] = w[nb*prinv_[c]+j];
+        }
+      } else {
+        casadi_clear(w, nb*nrow_ext);
+        for (casadi_int c=0; c<ncol; ++c) {
+          for (casadi_int j=0; j<nb; ++j) w[nb*prinv_[c]+j] = x[ncol*j+c];
+        }
+        casadi_qr_mv_blk(sp_v_, get_ptr(m->v), get_ptr(m->beta), w, 1, nb);
+        lev_r_.solve(get_ptr(m->r), w, nb);
+        for (casadi_int c=0; c<ncol; ++c) {
+          for (casadi_int j=0; j<nb; ++j) x[ncol*j+pc_[c]] = w[nb*c+j];
+        }
+      }
+      x += ncol*nb;
+    }
     return 0;
   }
 
@@ -141,7 +187,9 @@ namespace casadi {
     g << "casadi_real v[" << sp_v_.nnz() << "], "
          "r[" << sp_r_.nnz() << "], "
          "beta[" << ncol() << "], "
-         "w[" << nrow() + ncol() << "];\n";
+         "w[" << std::max(nrow() + ncol(),
+                          std::max(ncol(), sp_v_.size1())*std::min(nrhs, casadi_int(8)))
+         << "];\n";
 
     // Factorize
     g << g.qr(sp, A, "w", sp_v, "v", sp_r, "r", "beta", prinv, pc) << "\n";
@@ -154,22 +202,25 @@ namespace casadi {
   }
 
   LinsolQr::LinsolQr(DeserializingStream& s) : LinsolInternal(s) {
-    s.version("LinsolQr", 1);
+    s.version("LinsolQr", 2);
     s.unpack("LinsolQr::prinv", prinv_);
     s.unpack("LinsolQr::pc", pc_);
     s.unpack("LinsolQr::sp_v", sp_v_);
     s.unpack("LinsolQr::sp_r", sp_r_);
     s.unpack("LinsolQr::eps", eps_);
+    s.unpack("LinsolQr::parallel_solve_nnz", parallel_solve_nnz_);
+    init_levels();
   }
 
   void LinsolQr::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolQr", 1);
+    s.version("LinsolQr", 2);
     s.pack("LinsolQr::prinv", prinv_);
     s.pack("LinsolQr::pc", pc_);
     s.pack("LinsolQr::sp_v", sp_v_);
     s.pack("LinsolQr::sp_r", sp_r_);
     s.pack("LinsolQr::eps", eps_);
+    s.pack("LinsolQr::parallel_solve_nnz", parallel_solve_nnz_);
   }
 
 } // namespace casadi
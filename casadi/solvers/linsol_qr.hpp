@@ -34,6 +34,7 @@
 
 /// \cond INTERNAL
 #include "casadi/core/linsol_internal.hpp"
+#include "casadi/core/level_schedule.hpp"
 #include <casadi/solvers/casadi_linsol_qr_export.h>
 
 namespace casadi {
@@ -103,6 +104,14 @@ namespace casadi {
     std::vector<casadi_int> prinv_, pc_;
     Sparsity sp_v_, sp_r_;
     double eps_;
+    casadi_int parallel_solve_nnz_;
+
+    // Level schedules for multithreaded solves with R' and R
+    bool parallel_solve_;
+    LevelSchedule lev_rt_, lev_r_;
+
+    // Analyse the factor pattern for multithreaded solves
+    void init_levels();
 
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
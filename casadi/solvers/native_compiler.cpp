@@ -0,0 +1,305 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "native_compiler.hpp"
+#include "casadi/core/casadi_meta.hpp"
+#include "casadi/core/sx_function.hpp"
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define CASADI_NATIVE_X86_64
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_IMPORTER_NATIVE_EXPORT
+  casadi_register_importer_native(ImporterInternal::Plugin* plugin) {
+    plugin->creator = NativeCompiler::creator;
+    plugin->name = "native";
+    plugin->doc = NativeCompiler::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &ImporterInternal::options_;
+    plugin->exposed.jit_function = true;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_IMPORTER_NATIVE_EXPORT casadi_load_importer_native() {
+    ImporterInternal::registerPlugin(casadi_register_importer_native);
+  }
+
+  NativeCompiler::NativeCompiler(const std::string& name) :
+    ImporterInternal(name) {
+  }
+
+  NativeCompiler::~NativeCompiler() {
+#ifdef CASADI_NATIVE_X86_64
+    for (auto&& c : code_) munmap(c.first, c.second);
+#endif // CASADI_NATIVE_X86_64
+  }
+
+#ifdef CASADI_NATIVE_X86_64
+  namespace {
+    /// Scalar function called from the generated code
+    typedef double (*native_fcn_t)(double, double);
+
+    template<casadi_int I>
+    double native_fcn(double x, double y) {
+      double f;
+      BinaryOperationSS<I>::fcn(x, y, f, 1);
+      return f;
+    }
+
+    template<casadi_int I>
+    struct NativeFcn {
+      static void fcn(int, int, native_fcn_t& f, int) { f = native_fcn<I>;}
+    };
+
+    // General purpose registers (low three bits, bit 3 goes in REX)
+    enum {RAX = 0, RBX = 3, R12 = 12, R13 = 13};
+
+    /// Minimal x86-64 assembler for the instructions needed
+    class Assembler {
+    public:
+      std::vector<unsigned char> b;
+
+      void byte(unsigned char c) { b.push_back(c);}
+
+      void bytes(std::initializer_list<unsigned char> c) { b.insert(b.end(), c);}
+
+      void imm32(int32_t v) {
+        for (casadi_int k=0; k<4; ++k) byte(static_cast<unsigned char>(v >> (8*k)));
+      }
+
+      void imm64(uint64_t v) {
+        for (casadi_int k=0; k<8; ++k) byte(static_cast<unsigned char>(v >> (8*k)));
+      }
+
+      /// Byte offset of the k-th element of a double or pointer array
+      static int32_t disp(casadi_int k) {
+        casadi_assert(k>=0 && k < std::numeric_limits<int32_t>::max()/8,
+          "Offset out of range for native compilation");
+        return static_cast<int32_t>(8*k);
+      }
+
+      /** \brief Instruction with a [base+disp32] memory operand
+       *  prefix: mandatory prefix (0 for none), w: REX.W, reg: ModRM.reg
+       */
+      void mem(unsigned char prefix, bool w, std::initializer_list<unsigned char> opcode,
+               casadi_int reg, casadi_int base, int32_t d) {
+        if (prefix) byte(prefix);
+        unsigned char rex = 0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((base & 8) ? 1 : 0);
+        if (rex!=0x40) byte(rex);
+        bytes(opcode);
+        byte(static_cast<unsigned char>(0x80 | (reg & 7) << 3 | (base & 7)));
+        if ((base & 7)==4) byte(0x24); // SIB for rsp/r12 based addressing
+        imm32(d);
+      }
+
+      /// mov rax, [base+d]
+      void load_rax(casadi_int base, int32_t d) { mem(0, true, {0x8B}, RAX, base, d);}
+      /// mov [base+d], rax
+      void store_rax(casadi_int base, int32_t d) { mem(0, true, {0x89}, RAX, base, d);}
+      /// movsd xmm, [base+d]
+      void load_sd(casadi_int xmm, casadi_int base, int32_t d) {
+        mem(0xF2, false, {0x0F, 0x10}, xmm, base, d);
+      }
+      /// movsd [base+d], xmm
+      void store_sd(casadi_int xmm, casadi_int base, int32_t d) {
+        mem(0xF2, false, {0x0F, 0x11}, xmm, base, d);
+      }
+      /// mov rax, imm64
+      void mov_rax(uint64_t v) { bytes({0x48, 0xB8}); imm64(v);}
+      /// movq xmm1, rax
+      void movq_xmm1_rax() { bytes({0x66, 0x48, 0x0F, 0x6E, 0xC8});}
+      /// test rax, rax
+      void test_rax() { bytes({0x48, 0x85, 0xC0});}
+      /// Short forward jump, returns the position of the offset to be patched
+      size_t jump(unsigned char opcode) { byte(opcode); byte(0); return b.size()-1;}
+      /// Resolve a short forward jump to the current position
+      void land(size_t pos) {
+        size_t off = b.size() - pos - 1;
+        casadi_assert_dev(off < 128);
+        b[pos] = static_cast<unsigned char>(off);
+      }
+    };
+
+    uint64_t bits(double v) {
+      uint64_t r;
+      std::memcpy(&r, &v, sizeof(r));
+      return r;
+    }
+  } // namespace
+#endif // CASADI_NATIVE_X86_64
+
+  signal_t NativeCompiler::jit_function(const Function& f) {
+#ifdef CASADI_NATIVE_X86_64
+    casadi_assert(f.is_a("SXFunction", false),
+      "Native compilation is only supported for SXFunction, got " + f.class_name() + ".");
+    casadi_assert(!f.has_free(), "Native compilation of '" + f.name() + "' failed: "
+      "Cannot compile function with free variables " + str(f.get_free()) + ".");
+    const SXFunction* fcn = f.get<SXFunction>();
+
+    // Generated code has the signature of the eval field of casadi_functions:
+    // int f(const double** arg, double** res, casadi_int* iw, double* w, int mem)
+    // arg, res and w are kept in the callee-saved registers rbx, r12 and r13
+    Assembler a;
+    a.bytes({0x53, 0x41, 0x54, 0x41, 0x55}); // push rbx; push r12; push r13
+    a.bytes({0x48, 0x89, 0xFB}); // mov rbx, rdi
+    a.bytes({0x49, 0x89, 0xF4}); // mov r12, rsi
+    a.bytes({0x49, 0x89, 0xCD}); // mov r13, rcx
+    // Stack pointer is now 16-byte aligned, as required for calls
+
+    for (auto&& e : fcn->algorithm_) {
+      switch (e.op) {
+      case OP_CONST:
+        a.mov_rax(bits(e.d));
+        a.store_rax(R13, a.disp(e.i0));
+        break;
+      case OP_INPUT:
+        {
+          a.load_rax(RBX, a.disp(e.i1));
+          a.test_rax();
+          size_t jz = a.jump(0x74);
+          a.load_sd(0, RAX, a.disp(e.i2));
+          size_t jmp = a.jump(0xEB);
+          a.land(jz);
+          a.bytes({0x66, 0x0F, 0x57, 0xC0}); // xorpd xmm0, xmm0
+          a.land(jmp);
+          a.store_sd(0, R13, a.disp(e.i0));
+        }
+        break;
+      case OP_OUTPUT:
+        {
+          a.load_rax(R12, a.disp(e.i0));
+          a.test_rax();
+          size_t jz = a.jump(0x74);
+          a.load_sd(0, R13, a.disp(e.i1));
+          a.store_sd(0, RAX, a.disp(e.i2));
+          a.land(jz);
+        }
+        break;
+      case OP_ASSIGN:
+        a.load_rax(R13, a.disp(e.i1));
+        a.store_rax(R13, a.disp(e.i0));
+        break;
+      case OP_NEG:
+      case OP_FABS:
+        a.load_rax(R13, a.disp(e.i1));
+        // btc/btr rax, 63: flip or clear the sign bit
+        a.bytes({0x48, 0x0F, 0xBA, static_cast<unsigned char>(e.op==OP_NEG ? 0xF8 : 0xF0), 0x3F});
+        a.store_rax(R13, a.disp(e.i0));
+        break;
+      case OP_ADD:
+      case OP_SUB:
+      case OP_MUL:
+      case OP_DIV:
+        {
+          unsigned char opcode = e.op==OP_ADD ? 0x58 : e.op==OP_SUB ? 0x5C :
+                                 e.op==OP_MUL ? 0x59 : 0x5E;
+          a.load_sd(0, R13, a.disp(e.i1));
+          a.mem(0xF2, false, {0x0F, opcode}, 0, R13, a.disp(e.i2));
+          a.store_sd(0, R13, a.disp(e.i0));
+        }
+        break;
+      case OP_SQ:
+      case OP_TWICE:
+        a.load_sd(0, R13, a.disp(e.i1));
+        // mulsd/addsd xmm0, xmm0
+        a.bytes({0xF2, 0x0F, static_cast<unsigned char>(e.op==OP_SQ ? 0x59 : 0x58), 0xC0});
+        a.store_sd(0, R13, a.disp(e.i0));
+        break;
+      case OP_SQRT:
+        a.mem(0xF2, false, {0x0F, 0x51}, 0, R13, a.disp(e.i1));
+        a.store_sd(0, R13, a.disp(e.i0));
+        break;
+      case OP_INV:
+        a.mov_rax(bits(1));
+        a.bytes({0x66, 0x48, 0x0F, 0x6E, 0xC0}); // movq xmm0, rax
+        a.mem(0xF2, false, {0x0F, 0x5E}, 0, R13, a.disp(e.i1));
+        a.store_sd(0, R13, a.disp(e.i0));
+        break;
+      case OP_LT:
+      case OP_LE:
+      case OP_EQ:
+      case OP_NE:
+        {
+          unsigned char pred = e.op==OP_LT ? 1 : e.op==OP_LE ? 2 : e.op==OP_EQ ? 0 : 4;
+          a.load_sd(0, R13, a.disp(e.i1));
+          a.mem(0xF2, false, {0x0F, 0xC2}, 0, R13, a.disp(e.i2));
+          a.byte(pred);
+          // Turn the all-ones mask into 1.0
+          a.mov_rax(bits(1));
+          a.movq_xmm1_rax();
+          a.bytes({0x66, 0x0F, 0x54, 0xC1}); // andpd xmm0, xmm1
+          a.store_sd(0, R13, a.disp(e.i0));
+        }
+        break;
+      default:
+        {
+          // Call a compiled scalar implementation of the operation
+          native_fcn_t fptr = nullptr;
+          switch (e.op) {
+            CASADI_MATH_FUN_BUILTIN_GEN(NativeFcn, 0, 0, fptr, 0)
+          default:
+            casadi_error("Native compilation of '" + f.name() + "' failed: "
+              "Operation " + str(e.op) + " not supported.");
+          }
+          a.load_sd(0, R13, a.disp(e.i1));
+          if (casadi_math<double>::ndeps(e.op)==2) a.load_sd(1, R13, a.disp(e.i2));
+          a.mov_rax(reinterpret_cast<uint64_t>(fptr));
+          a.bytes({0xFF, 0xD0}); // call rax
+          a.store_sd(0, R13, a.disp(e.i0));
+        }
+      }
+    }
+
+    a.bytes({0x31, 0xC0}); // xor eax, eax
+    a.bytes({0x41, 0x5D, 0x41, 0x5C, 0x5B}); // pop r13; pop r12; pop rbx
+    a.byte(0xC3); // ret
+
+    // Copy to executable memory
+    size_t sz = a.b.size();
+    void* buf = mmap(nullptr, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    casadi_assert(buf!=MAP_FAILED, "Native compilation: Failed to allocate memory.");
+    std::memcpy(buf, a.b.data(), sz);
+    if (mprotect(buf, sz, PROT_READ | PROT_EXEC)) {
+      munmap(buf, sz);
+      casadi_error("Native compilation: Failed to make memory executable.");
+    }
+    code_.push_back(std::make_pair(buf, sz));
+    if (verbose_) casadi_message("Compiled '" + f.name() + "' to " + str(sz) + " bytes.");
+    return reinterpret_cast<signal_t>(buf);
+#else // CASADI_NATIVE_X86_64
+    casadi_error("Native compilation is only available on x86-64 (System V).");
+    return nullptr;
+#endif // CASADI_NATIVE_X86_64
+  }
+
+} // namespace casadi
@@ -0,0 +1,87 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_NATIVE_COMPILER_HPP
+#define CASADI_NATIVE_COMPILER_HPP
+
+#include "casadi/core/importer_internal.hpp"
+#include <casadi/solvers/casadi_importer_native_export.h>
+#include "casadi/core/plugin_interface.hpp"
+
+/** \defgroup plugin_Importer_native
+      In-process just-in-time compiler for SX functions
+
+      Machine code for x86-64 (System V calling convention) is emitted directly
+      from the instructions of an SXFunction, without code generation to C or an
+      external compiler. Other function classes are not supported.
+*/
+
+/** \pluginsection{Importer,native} */
+
+/// \cond INTERNAL
+namespace casadi {
+  /** \brief \pluginbrief{Importer,native}
+
+   @copydoc Importer_doc
+   @copydoc plugin_Importer_native
+   * */
+  class CASADI_IMPORTER_NATIVE_EXPORT NativeCompiler : public ImporterInternal {
+  public:
+
+    /** \brief Constructor */
+    explicit NativeCompiler(const std::string& name);
+
+    /** \brief  Create a new JIT function */
+    static ImporterInternal* creator(const std::string& name) {
+      return new NativeCompiler(name);
+    }
+
+    /** \brief Destructor */
+    ~NativeCompiler() override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Get name of plugin
+    const char* plugin_name() const override { return "native";}
+
+    // Get name of the class
+    std::string class_name() const override { return "NativeCompiler";}
+
+    /// No source file to read meta information from
+    bool can_have_meta() const override { return false;}
+
+    /// Compile an SX function to machine code
+    signal_t jit_function(const Function& f) override;
+
+  protected:
+    /// Executable buffers, with their sizes
+    std::vector<std::pair<void*, size_t> > code_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_NATIVE_COMPILER_HPP
@@ -80,7 +80,12 @@ namespace casadi {
         "Printed numbers are 0-based indices into the vector of [simple bounds;linear bounds]"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"max_kkt_updates",
+       {OT_INT,
+        "Maximum number of KKT columns changed by active-set changes before the QR "
+        "factorization is recomputed [20]. In between, the factorization is updated. "
+        "With 0, it is recomputed whenever the active set changes."}}
      }
   };
 
@@ -116,6 +121,8 @@ namespace casadi {
         p_.dual_inf_tol = op.second;
       } else if (op.first=="min_lam") {
         p_.min_lam = op.second;
+      } else if (op.first=="max_kkt_updates") {
+        p_.max_kkt_updates = op.second;
       } else if (op.first=="print_iter") {
         print_iter_ = op.second;
       } else if (op.first=="print_header") {
@@ -126,6 +133,7 @@ namespace casadi {
         print_lincomb_ = op.second;
       }
     }
+    casadi_assert(p_.max_kkt_updates>=0, "Option 'max_kkt_updates' must be nonnegative");
 
     // Allocate memory
     casadi_int sz_w, sz_iw;
@@ -163,6 +171,14 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<QrqpMemory*>(mem);
     m->return_status = "";
+    m->iter_count = m->n_fact = m->n_update = 0;
+    // Factorization kept between calls
+    m->n_up = -1;
+    if (reuse_factorization_) {
+      casadi_int nz = p_.nz, mu = p_.max_kkt_updates;
+      m->w_fact.resize(max(sp_v_.nnz()+sp_r_.nnz(), kkt_.nnz()) + nz + nz*mu + mu*mu);
+      m->iw_fact.resize(2*nz + 3*mu);
+    }
     return 0;
   }
 
@@ -178,6 +194,22 @@ namespace casadi {
     d.g = arg[CONIC_G];
     d.nz_a = arg[CONIC_A];
     casadi_qp_init(&d, &iw, &w);
+    // Keep the factorization in the memory object instead of the work vectors
+    if (reuse_factorization_) {
+      casadi_int nz = p_.nz, mu = p_.max_kkt_updates;
+      double* wf = get_ptr(m->w_fact);
+      casadi_int* iwf = get_ptr(m->iw_fact);
+      d.nz_v = wf; wf += max(sp_v_.nnz()+sp_r_.nnz(), kkt_.nnz());
+      d.nz_r = d.nz_v + sp_v_.nnz();
+      d.beta = wf; wf += nz;
+      d.up_z = wf; wf += nz*mu;
+      d.up_c = wf;
+      d.up_active = iwf; iwf += nz;
+      d.up_slot = iwf; iwf += nz;
+      d.up_ind = iwf; iwf += mu;
+      d.up_sign = iwf; iwf += mu;
+      d.up_piv = iwf;
+    }
     // Pass bounds on z
     casadi_copy(arg[CONIC_LBX], nx_, d.lbz);
     casadi_copy(arg[CONIC_LBA], na_, d.lbz+nx_);
@@ -190,6 +222,10 @@ namespace casadi {
     casadi_copy(arg[CONIC_LAM_A0], na_, d.lam+nx_);
     // Reset solver
     if (casadi_qp_reset(&d)) return 1;
+    // Start from the factorization of the previous call, if H and A are unchanged
+    if (reuse_factorization(m, d.nz_h, d.nz_a)) d.n_up = m->n_up;
+    // The factorization in memory is overwritten, invalid until a successful exit
+    m->n_up = -1;
     while (true) {
       // Prepare QP
       int flag = casadi_qp_prepare(&d);
@@ -235,11 +271,16 @@ namespace casadi {
         m->return_status = "Printing error";
         break;
     }
+    m->iter_count = d.iter;
+    m->n_fact = d.n_fact;
+    m->n_update = d.n_update;
     // Get solution
     casadi_copy(&d.f, 1, res[CONIC_COST]);
     casadi_copy(d.z, nx_, res[CONIC_X]);
     casadi_copy(d.lam, nx_, res[CONIC_LAM_X]);
     casadi_copy(d.lam+nx_, na_, res[CONIC_LAM_A]);
+    // Factorization for the next call
+    if (d.status == QP_SUCCESS) m->n_up = d.n_up;
     // Return
     if (verbose_) casadi_warning(m->return_status);
     m->success = d.status == QP_SUCCESS;
@@ -271,6 +312,7 @@ namespace casadi {
     g << "p.min_lam = " << p_.min_lam << ";\n";
     g << "p.constr_viol_tol = " << p_.constr_viol_tol << ";\n";
     g << "p.dual_inf_tol = " << p_.dual_inf_tol << ";\n";
+    g << "p.max_kkt_updates = " << p_.max_kkt_updates << ";\n";
 
     // Setup data structure
     g << "d.prob = &p;\n";
@@ -327,11 +369,14 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["iter_count"] = m->iter_count;
+    stats["n_factorizations"] = m->n_fact;
+    stats["n_kkt_updates"] = m->n_update;
     return stats;
   }
 
   Qrqp::Qrqp(DeserializingStream& s) : Conic(s) {
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 2);
     s.unpack("Qrqp::AT", AT_);
     s.unpack("Qrqp::kkt", kkt_);
     s.unpack("Qrqp::sp_v", sp_v_);
@@ -347,12 +392,13 @@ namespace casadi {
     s.unpack("Qrqp::min_lam", p_.min_lam);
     s.unpack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.unpack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    s.unpack("Qrqp::max_kkt_updates", p_.max_kkt_updates);
   }
 
   void Qrqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 2);
     s.pack("Qrqp::AT", AT_);
     s.pack("Qrqp::kkt", kkt_);
     s.pack("Qrqp::sp_v", sp_v_);
@@ -367,6 +413,7 @@ namespace casadi {
     s.pack("Qrqp::min_lam", p_.min_lam);
     s.pack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.pack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    s.pack("Qrqp::max_kkt_updates", p_.max_kkt_updates);
   }
 
 } // namespace casadi
@@ -39,6 +39,13 @@
 namespace casadi {
   struct CASADI_CONIC_QRQP_EXPORT QrqpMemory : public ConicMemory {
     const char* return_status;
+    // Number of iterations, KKT factorizations and factorization updates
+    casadi_int iter_count, n_fact, n_update;
+    // QR factorization of the KKT matrix and its updates, kept between calls
+    std::vector<double> w_fact;
+    std::vector<casadi_int> iw_fact;
+    // Number of KKT columns changed since the factorization, -1 if none
+    casadi_int n_up;
   };
 
   /** \brief \pluginbrief{Conic,qrqp}
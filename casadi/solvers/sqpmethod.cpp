@@ -71,7 +71,9 @@ namespace casadi {
         "The QP solver to be used by the SQP method [qpoases]"}},
       {"qpsol_options",
        {OT_DICT,
-        "Options to be passed to the QP solver"}},
+        "Options to be passed to the QP solver. Unless set here, 'reuse_factorization' "
+        "is enabled, so that the QP solver is hot started between iterations and solves "
+        "whenever the QP matrices are unchanged"}},
       {"hessian_approximation",
        {OT_STRING,
         "limited-memory|exact"}},
@@ -291,6 +293,9 @@ namespace casadi {
 
     // Allocate a QP solver
     casadi_assert(!qpsol_plugin.empty(), "'qpsol' option has not been set");
+    if (qpsol_options.find("reuse_factorization")==qpsol_options.end()) {
+      qpsol_options["reuse_factorization"] = true;
+    }
     qpsol_ = conic("qpsol", qpsol_plugin, {{"h", Hsp_}, {"a", Asp_}},
                    qpsol_options);
     alloc(qpsol_);
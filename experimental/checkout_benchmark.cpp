@@ -0,0 +1,82 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include <casadi/casadi.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace casadi;
+using namespace std;
+
+/** \brief Throughput of Function::checkout/release under contention
+
+    Usage: checkout_benchmark [max_threads] [iterations per thread]
+    Each thread repeatedly checks out and releases a memory object of the same
+    Function, optionally followed by a (cheap) numerical evaluation.
+*/
+int main(int argc, char* argv[]) {
+  int max_threads = argc>1 ? atoi(argv[1]) : 32;
+  int n_iter = argc>2 ? atoi(argv[2]) : 200000;
+
+  SX x = SX::sym("x", 4);
+  Function f("f", {x}, {sin(x)*dot(x, x)});
+
+  cout << setw(8) << "threads" << setw(24) << "checkout/release [1/s]"
+       << setw(24) << "eval [1/s]" << endl;
+  for (int nt=1; nt<=max_threads; nt*=2) {
+    for (bool eval : {false, true}) {
+      auto t0 = chrono::steady_clock::now();
+      vector<thread> threads;
+      for (int t=0; t<nt; ++t) {
+        threads.emplace_back([&]() {
+          vector<const double*> arg(f.sz_arg());
+          vector<double*> res(f.sz_res());
+          vector<casadi_int> iw(f.sz_iw());
+          vector<double> w(f.sz_w());
+          double x_val[4] = {1, 2, 3, 4}, r_val[4];
+          arg[0] = x_val;
+          res[0] = r_val;
+          for (int i=0; i<n_iter; ++i) {
+            if (eval) {
+              f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w));
+            } else {
+              f.release(f.checkout());
+            }
+          }
+        });
+      }
+      for (auto&& th : threads) th.join();
+      double t = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+      double rate = nt*static_cast<double>(n_iter)/t;
+      if (!eval) {
+        cout << setw(8) << nt << setw(24) << rate;
+      } else {
+        cout << setw(24) << rate << endl;
+      }
+    }
+  }
+  return 0;
+}
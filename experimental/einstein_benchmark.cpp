@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include <casadi/casadi.hpp>
+
+#include <chrono>
+#include <map>
+
+using namespace casadi;
+using namespace std;
+
+/** \brief Contraction in einsum notation, e.g. "ik,kj->ij"
+
+    Indices are single letters, the first index of a tensor varies fastest.
+*/
+struct Pattern {
+  string spec;
+  map<char, casadi_int> size;
+  string a, b, c;
+  Pattern(const string& spec, const map<char, casadi_int>& size) : spec(spec), size(size) {
+    size_t comma = spec.find(','), arrow = spec.find("->");
+    a = spec.substr(0, comma);
+    b = spec.substr(comma+1, arrow-comma-1);
+    c = spec.substr(arrow+2);
+  }
+  vector<casadi_int> dims(const string& s) const {
+    vector<casadi_int> ret;
+    for (char l : s) ret.push_back(size.at(l));
+    return ret;
+  }
+  vector<casadi_int> labels(const string& s) const {
+    vector<casadi_int> ret;
+    for (char l : s) ret.push_back(-1-(l-'a'));
+    return ret;
+  }
+  casadi_int numel(const string& s) const { return product(dims(s));}
+  /// Reference implementation, one multiplication per combination of indices
+  vector<double> reference(const vector<double>& A, const vector<double>& B) const {
+    vector<double> C(numel(c), 0);
+    casadi_int n_iter = 1;
+    for (auto& e : size) n_iter *= e.second;
+    map<char, casadi_int> ind;
+    for (casadi_int i=0; i<n_iter; ++i) {
+      casadi_int sub = i;
+      for (auto& e : size) {
+        ind[e.first] = sub % e.second;
+        sub /= e.second;
+      }
+      auto offset = [&](const string& s) {
+        casadi_int ret = 0, cumprod = 1;
+        for (char l : s) {
+          ret += ind[l]*cumprod;
+          cumprod *= size.at(l);
+        }
+        return ret;
+      };
+      C[offset(c)] += A[offset(a)]*B[offset(b)];
+    }
+    return C;
+  }
+};
+
+/** \brief Throughput of MX Einstein contractions for common einsum patterns
+
+    Usage: einstein_benchmark [size]
+    The number of threads can be set with GlobalOptions::setNumThreads.
+*/
+int main(int argc, char* argv[]) {
+  casadi_int n = argc>1 ? atoi(argv[1]) : 128;
+  casadi_int nb = 8;
+  vector<Pattern> patterns = {
+    {"ik,kj->ij", {{'i', n}, {'j', n}, {'k', n}}},
+    {"ki,kj->ij", {{'i', n}, {'j', n}, {'k', n}}},
+    {"kj,ik->ij", {{'i', n}, {'j', n}, {'k', n}}},
+    {"ikb,kjb->ijb", {{'i', n}, {'j', n}, {'k', n}, {'b', nb}}},
+    {"ijk,k->ij", {{'i', n}, {'j', n}, {'k', n}}},
+    {"ijk,j->ik", {{'i', n}, {'j', n}, {'k', n}}},
+    {"ij,ij->", {{'i', 8*n}, {'j', 8*n}}},
+    {"i,j->ij", {{'i', 8*n}, {'j', 8*n}}},
+    {"ijk,jl->ilk", {{'i', n/4}, {'j', n}, {'k', n/4}, {'l', n}}}};
+
+  cout << setw(14) << "pattern" << setw(14) << "time [ms]" << setw(14) << "[GFLOP/s]"
+       << setw(14) << "error" << endl;
+  for (const Pattern& p : patterns) {
+    MX A = MX::sym("A", p.numel(p.a));
+    MX B = MX::sym("B", p.numel(p.b));
+    MX C = MX::einstein(A, B, p.dims(p.a), p.dims(p.b), p.dims(p.c),
+                        p.labels(p.a), p.labels(p.b), p.labels(p.c));
+    Function f("f", {A, B}, {C});
+
+    vector<double> a(p.numel(p.a)), b(p.numel(p.b));
+    for (size_t i=0; i<a.size(); ++i) a[i] = sin(static_cast<double>(i));
+    for (size_t i=0; i<b.size(); ++i) b[i] = cos(static_cast<double>(i));
+    vector<double> c(p.numel(p.c));
+
+    // Repeat until at least 0.2 s have passed
+    casadi_int n_rep = 0;
+    double t = 0;
+    auto t0 = chrono::steady_clock::now();
+    while (t<0.2) {
+      f({get_ptr(a), get_ptr(b)}, {get_ptr(c)});
+      n_rep++;
+      t = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    }
+    t /= n_rep;
+
+    casadi_int n_flop = 2;
+    for (auto& e : p.size) n_flop *= e.second;
+    vector<double> c_ref = p.reference(a, b);
+    double err = 0;
+    for (size_t i=0; i<c.size(); ++i) err = fmax(err, fabs(c[i]-c_ref[i]));
+
+    cout << setw(14) << p.spec << setw(14) << 1e3*t << setw(14) << n_flop/t*1e-9
+         << setw(14) << err << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include <casadi/casadi.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace casadi;
+using namespace std;
+
+/** \brief Writer for synthetic .nl files, in text ('g') or binary ('b') format
+
+    The problem has n variables and n-1 constraints
+      g_i = x_i*x_{i+1} + sin(x_i) + 0.5*x_i + 2*x_{i+1}
+    with an objective sum_i x_i^2 + sum_i x_i/n
+*/
+class NlWriter {
+public:
+  NlWriter(const string& fname, bool binary) : binary_(binary) {
+    f_ = fopen(fname.c_str(), binary ? "wb" : "w");
+  }
+  ~NlWriter() { fclose(f_);}
+  void key(char c) { fputc(c, f_);}
+  void i(int v, bool newline=true) {
+    if (binary_) {
+      fwrite(&v, sizeof(int), 1, f_);
+    } else {
+      fprintf(f_, newline ? "%d\n" : "%d ", v);
+    }
+  }
+  void d(double v, bool newline=true) {
+    if (binary_) {
+      fwrite(&v, sizeof(double), 1, f_);
+    } else {
+      fprintf(f_, newline ? "%.17g\n" : "%.17g ", v);
+    }
+  }
+  void header(int n) {
+    int m = n-1;
+    fprintf(f_, "%c3 1 1 0\t# problem synthetic\n", binary_ ? 'b' : 'g');
+    fprintf(f_, " %d %d 1 0 0\t# vars, constraints, objectives, ranges, eqns\n", n, m);
+    fprintf(f_, " %d 1\t# nonlinear constraints, objectives\n", m);
+    fprintf(f_, " 0 0\t# network constraints: nonlinear, linear\n");
+    fprintf(f_, " %d %d %d\t# nonlinear vars in constraints, objectives, both\n", n, n, n);
+    fprintf(f_, " 0 0 0 1\t# linear network variables; functions; arith, flags\n");
+    fprintf(f_, " 0 0 0 0 0\t# discrete variables: binary, integer, nonlinear (b,c,o)\n");
+    fprintf(f_, " %d %d\t# nonzeros in Jacobian, gradients\n", 2*m, n);
+    fprintf(f_, " 0 0\t# max name lengths: constraints, variables\n");
+    fprintf(f_, " 0 0 0 0 0\t# common exprs: b,c,o,c1,o1\n");
+  }
+  void write(int n) {
+    int m = n-1;
+    header(n);
+    // Nonlinear parts of the constraints
+    for (int k=0; k<m; ++k) {
+      key('C'); i(k);
+      key('o'); i(0);
+      key('o'); i(2); key('v'); i(k); key('v'); i(k+1);
+      key('o'); i(41); key('v'); i(k);
+    }
+    // Nonlinear part of the objective
+    key('O'); i(0, false); i(0);
+    key('o'); i(54); i(n);
+    for (int k=0; k<n; ++k) {
+      key('o'); i(5); key('v'); i(k); key('n'); d(2);
+    }
+    // Initial guess
+    key('x'); i(n);
+    for (int k=0; k<n; ++k) {
+      i(k, false); d(0.1*k);
+    }
+    // Constraint bounds, cycling through the bound types
+    key('r'); if (!binary_) fputc('\n', f_);
+    for (int k=0; k<m; ++k) {
+      switch (k%4) {
+        case 0: key('0'); if (!binary_) fputc(' ', f_); d(-1, false); d(1); break;
+        case 1: key('1'); if (!binary_) fputc(' ', f_); d(2.5); break;
+        case 2: key('2'); if (!binary_) fputc(' ', f_); d(-3); break;
+        default: key('4'); if (!binary_) fputc(' ', f_); d(0.25); break;
+      }
+    }
+    // Variable bounds
+    key('b'); if (!binary_) fputc('\n', f_);
+    for (int k=0; k<n; ++k) {
+      if (k%2) {
+        key('3'); if (!binary_) fputc('\n', f_);
+      } else {
+        key('0'); if (!binary_) fputc(' ', f_); d(-10, false); d(10);
+      }
+    }
+    // Jacobian column counts
+    key('k'); i(n-1);
+    for (int k=0; k<n-1; ++k) i(k==0 ? 1 : 2*k+1);
+    // Linear parts of the constraints
+    for (int k=0; k<m; ++k) {
+      key('J'); i(k, false); i(2);
+      i(k, false); d(0.5);
+      i(k+1, false); d(2);
+    }
+    // Linear part of the objective
+    key('G'); i(0, false); i(n);
+    for (int k=0; k<n; ++k) {
+      i(k, false); d(1./n);
+    }
+  }
+private:
+  FILE* f_;
+  bool binary_;
+};
+
+/** \brief Throughput of the .nl importer
+
+    Usage: nl_import_benchmark [number of variables]
+    Writes a synthetic problem in text and binary .nl format and
+    imports both.
+*/
+int main(int argc, char* argv[]) {
+  int n = argc>1 ? atoi(argv[1]) : 100000;
+
+  cout << setw(8) << "format" << setw(14) << "size [MB]" << setw(14) << "import [s]"
+       << setw(14) << "[MB/s]" << endl;
+  for (bool binary : {false, true}) {
+    string fname = binary ? "synthetic_b.nl" : "synthetic_g.nl";
+    {
+      NlWriter w(fname, binary);
+      w.write(n);
+    }
+    ifstream in(fname, ios::binary | ios::ate);
+    double sz = static_cast<double>(in.tellg())/1e6;
+    NlpBuilder nl;
+    auto t0 = chrono::steady_clock::now();
+    nl.import_nl(fname);
+    double t = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << setw(8) << (binary ? "binary" : "text") << setw(14) << sz
+         << setw(14) << t << setw(14) << sz/t << endl;
+    casadi_assert(nl.g.size()==static_cast<size_t>(n-1), "Unexpected number of constraints");
+    remove(fname.c_str());
+  }
+  return 0;
+}
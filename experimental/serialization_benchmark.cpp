@@ -0,0 +1,94 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include <casadi/casadi.hpp>
+
+#include <chrono>
+#include <functional>
+
+using namespace casadi;
+using namespace std;
+
+/** \brief Throughput of Function serialization and deserialization
+
+    Usage: serialization_benchmark [number of terms]
+    Saves and loads an SX function with a long algorithm, an MX function
+    embedding a large sparse matrix and a large DM, then compares loading
+    the functions from text and binary files.
+*/
+int main(int argc, char* argv[]) {
+  casadi_int n = argc>1 ? atoi(argv[1]) : 100000;
+
+  // Chain of operations, every term depending on a few variables
+  SX x = SX::sym("x", n);
+  vector<SX> e(n);
+  for (casadi_int i=0; i<n; ++i) {
+    e[i] = sin(x(i))*x((7*i+1)%n) + cos(x((13*i+5)%n))/(1+sq(SX(x(i))));
+  }
+  Function f("f", {x}, {vertcat(e)});
+  MX xm = MX::sym("x", n);
+  DM A = DM::ones(Sparsity::banded(n, 5));
+  Function jac_f("jac_f", {xm}, {mtimes(A, f(vector<MX>{xm})[0])});
+  DM d = DM::rand(n, 10);
+
+  cout << setw(8) << "object" << setw(14) << "size [MB]"
+       << setw(18) << "save [MB/s]" << setw(18) << "load [MB/s]" << endl;
+  auto bench = [](const string& name, const std::function<string()>& save,
+                  const std::function<void(const string&)>& load) {
+    auto t0 = chrono::steady_clock::now();
+    string str = save();
+    double t_save = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    double sz = static_cast<double>(str.size())/1e6;
+    t0 = chrono::steady_clock::now();
+    load(str);
+    double t_load = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << setw(8) << name << setw(14) << sz
+         << setw(18) << sz/t_save << setw(18) << sz/t_load << endl;
+  };
+  bench("SX", [&]() { return f.serialize();},
+        [&](const string& s) { Function::deserialize(s);});
+  bench("MX", [&]() { return jac_f.serialize();},
+        [&](const string& s) { Function::deserialize(s);});
+  bench("DM", [&]() { return d.serialize();},
+        [&](const string& s) { DM::deserialize(s);});
+
+  // Loading from file, text versus binary
+  cout << endl << setw(8) << "object" << setw(14) << "format"
+       << setw(14) << "size [MB]" << setw(14) << "load [s]" << endl;
+  for (const Function& g : {f, jac_f}) {
+    for (bool binary : {false, true}) {
+      string fname = g.name() + (binary ? ".bin" : ".casadi");
+      g.save(fname, {{"binary", binary}});
+      ifstream in(fname, ios::binary | ios::ate);
+      double sz = static_cast<double>(in.tellg())/1e6;
+      auto t0 = chrono::steady_clock::now();
+      Function::load(fname);
+      double t_load = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+      cout << setw(8) << g.name() << setw(14) << (binary ? "binary" : "text")
+           << setw(14) << sz << setw(14) << t_load << endl;
+      remove(fname.c_str());
+    }
+  }
+  return 0;
+}
@@ -80,6 +80,7 @@ if has_conic("cbc"):
 
 if has_conic("qrqp"):
   conics.append(("qrqp",{"max_iter":20,"print_header":False,"print_iter":False},{"quadratic": True, "dual": True, "soc": False, "codegen": True, "discrete": False, "sos":False}))
+  conics.append(("qrqp",{"max_iter":20,"print_header":False,"print_iter":False,"max_kkt_updates":0},{"quadratic": True, "dual": True, "soc": False, "codegen": True, "discrete": False, "sos":False}))
 
 
 print(conics)
@@ -1239,5 +1240,67 @@ class ConicTests(casadiTestCase):
       with self.assertInException("process"):
         solver(x0=0,lbg=0,ubg=0,lbx=[-10,-10],ubx=[10,10])
 
+  @requires_conic("qrqp")
+  def test_qrqp_kkt_updates(self):
+    n = 30
+    na = 10
+    H = DM.zeros(n,n)
+    g = DM.zeros(n)
+    A = DM.zeros(na,n)
+    for i in range(n):
+      H[i,i] = 2+numpy.sin(i)
+      if i+1<n:
+        H[i,i+1] = H[i+1,i] = 0.5*numpy.cos(i)
+      g[i] = 10*numpy.sin(3*i+1)
+      for j in range(na):
+        if i%na==j or (i+1)%na==j: A[j,i] = numpy.cos(j+2*i)
+    solver_in = dict(h=H,g=g,a=A,lbx=-1,ubx=1,lba=-0.5,uba=0.5)
+
+    sols = []
+    for max_kkt_updates in [0,3,100]:
+      solver = conic("solver","qrqp",{"h":H.sparsity(),"a":A.sparsity()},{"max_kkt_updates":max_kkt_updates,"print_iter":False,"print_header":False})
+      sols.append((solver(**solver_in),solver.stats()))
+      stats = sols[-1][1]
+      self.assertTrue(stats["success"])
+      # Many active-set changes
+      self.assertTrue(stats["iter_count"]>=10)
+      if max_kkt_updates==0:
+        self.assertEqual(stats["n_kkt_updates"],0)
+      else:
+        self.assertTrue(stats["n_kkt_updates"]>0)
+        self.assertTrue(stats["n_factorizations"]<stats["iter_count"])
+    for sol, stats in sols[1:]:
+      self.assertEqual(stats["iter_count"],sols[0][1]["iter_count"])
+      for k in ["x","lam_x","lam_a","cost"]:
+        self.checkarray(sol[k],sols[0][0][k],digits=8)
+
+  def test_reuse_factorization(self):
+    H = DM([[1,-1],[-1,2]])
+    A =  DM([[1, 1],[-1, 2],[2, 1]])
+
+    for conic, qp_options, aux_options in conics:
+      if not aux_options["quadratic"]: continue
+      opts = dict(qp_options)
+      solver = casadi.conic("mysolver",conic,{'h':H.sparsity(),'a':A.sparsity()},opts)
+      opts["reuse_factorization"] = True
+      solver_hot = casadi.conic("mysolver",conic,{'h':H.sparsity(),'a':A.sparsity()},opts)
+      digits = max(1,6-aux_options.get("less_digits",0))
+
+      lam_x0 = DM.zeros(2)
+      lam_a0 = DM.zeros(3)
+      HH_prev = None
+      for G, HH in [([-2,-6],H),([-3,-5],H),([-1,-7],H),([-2,-6],2*H),([-2,-6],2*H)]:
+        solver_in = dict(h=HH,g=G,a=A,lbx=0,ubx=inf,lba=-inf,uba=[2,2,3],lam_x0=lam_x0,lam_a0=lam_a0)
+        solver_out = solver(**solver_in)
+        solver_out_hot = solver_hot(**solver_in)
+        self.checkarray(solver_out_hot["x"],solver_out["x"],conic,digits=digits)
+        if aux_options["dual"]: self.checkarray(solver_out_hot["lam_a"],solver_out["lam_a"],conic,digits=digits)
+        # The kept factorization is used when H and A are unchanged
+        if conic=="qrqp" and HH_prev is not None and float(norm_inf(HH-HH_prev))==0:
+          self.assertTrue(solver_hot.stats()["n_factorizations"]<solver.stats()["n_factorizations"])
+        HH_prev = HH
+        lam_x0 = solver_out["lam_x"]
+        lam_a0 = solver_out["lam_a"]
+
 if __name__ == '__main__':
     unittest.main()
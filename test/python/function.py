@@ -626,6 +626,111 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_map_thread_pool(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+
+    fun = Function("f",[x,y],[sin(x*y),x**2])
+
+    n = 100
+    X_ = DM.rand(1,n)
+    Y_ = DM.rand(2,n)
+
+    num_threads = GlobalOptions.getNumThreads()
+    try:
+      for t in [1,3,0]:
+        GlobalOptions.setNumThreads(t)
+        self.checkfunction_light(fun.map(n,"thread"),fun.map(n),inputs=[X_,Y_])
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+
+  def test_parallel_coloring(self):
+    x = SX.sym("x",40)
+    # Banded Jacobian and arrowhead-like Hessian
+    e = vertcat(*[x[i]*x[i+1]+sin(x[i+2]) for i in range(38)],x[0]*sum1(x))
+    num_threads = GlobalOptions.getNumThreads()
+    try:
+      GlobalOptions.setNumThreads(4)
+      for opts in [{},{"ad_weight":0},{"ad_weight":1}]:
+        f = Function("f",[x],[e],opts)
+        fp = Function("f",[x],[e],dict(opts,parallel_coloring=True))
+        x0 = DM.rand(40)
+        self.checkarray(f.jacobian_old(0,0)(x0)[0],fp.jacobian_old(0,0)(x0)[0])
+
+      # Hessian via star coloring
+      g = Function("g",[x],[dot(e,e)])
+      gp = Function("g",[x],[dot(e,e)],{"parallel_coloring":True})
+      x0 = DM.rand(40)
+      self.checkarray(g.hessian_old(0,0)(x0)[0],gp.hessian_old(0,0)(x0)[0])
+      self.assertTrue("t_wall_coloring" in gp.stats())
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+
+  def test_sparsity_threads(self):
+    x = SX.sym("x",400)
+    e = vertcat(*[x[i]*x[(7*i+3)%400]+sin(x[(13*i+1)%400]) for i in range(400)])
+    num_threads = GlobalOptions.getNumThreads()
+    hierarchical = GlobalOptions.getHierarchicalSparsity()
+    try:
+      for h in [False,True]:
+        GlobalOptions.setHierarchicalSparsity(h)
+        for opts in [{"ad_weight_sp":0},{"ad_weight_sp":1}]:
+          sp = []
+          for n in [1,4]:
+            GlobalOptions.setNumThreads(n)
+            f = Function("f",[x],[e],opts)
+            sp.append(f.sparsity_jac(0,0))
+          self.assertTrue(sp[0]==sp[1])
+          self.assertTrue(sp[0]==jacobian(e,x).sparsity())
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+      GlobalOptions.setHierarchicalSparsity(hierarchical)
+
+  def test_map_batch(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",2,2)
+
+    fun = Function("f",[x,y,z],[mtimes(z,y)+x,sin(y*x).T,fmax(x,y[0])**2])
+
+    # Numbers of points that do and do not fill up the blocks
+    for n in [1,8,19]:
+      X_ = DM.rand(1,n)
+      Y_ = DM.rand(2,n)
+      Z_ = DM.rand(2,2*n)
+
+      res = fun.map(n)(X_,Y_,Z_)
+      for i in range(n):
+        resref = fun(X_[:,i],Y_[:,i],Z_[:,2*i:2*i+2])
+        for r,rref in zip(res,resref):
+          self.checkarray(r[:,i*rref.size2():(i+1)*rref.size2()],rref,digits=14)
+
+      # Missing inputs and outputs
+      res = fun.map(n).call({"i0":X_})
+      self.checkarray(res["o0"],repmat(X_,2,1),digits=14)
+
+    # Batched evaluation is used for interpreted functions only
+    funv = Function("f",[x,y,z],[mtimes(z,y)+x,sin(y*x).T,fmax(x,y[0])**2],{"verbose":True})
+    with self.assertOutput("f::eval_batch",[]):
+      funv.map(n)(X_,Y_,Z_)
+
+  @requiresPlugin(Importer,"native")
+  def test_map_batch_jit(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    e = [sin(y*x),fmax(x,y[0])**2]
+    fun = Function("f",[x,y],e)
+    funj = Function("f",[x,y],e,{"verbose":True,"jit":True,"compiler":"native"})
+    X_ = DM.rand(1,19)
+    Y_ = DM.rand(2,19)
+
+    # The compiled code is called for every point, no batch work vector
+    self.assertTrue(funj.map(19).sz_w()<fun.map(19).sz_w())
+    with self.assertOutput([],"f::eval_batch"):
+      res = funj.map(19)(X_,Y_)
+    for r,rref in zip(res,fun.map(19)(X_,Y_)):
+      self.checkarray(r,rref,digits=15)
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -1066,7 +1171,7 @@ class Functiontests(casadiTestCase):
   def test_1d_interpolant_uniform(self):
     grid = [[0, 1, 2]]
     values = [0, 1, 2]
-    for opts in [{"lookup_mode": ["linear"]},{"lookup_mode": ["exact"]},{"lookup_mode": ["binary"]}]:
+    for opts in [{"lookup_mode": ["linear"]},{"lookup_mode": ["exact"]},{"lookup_mode": ["binary"]},{"lookup_mode": ["bucket"]}]:
       F = interpolant('F', 'linear', grid, values, opts)
       def same(a, b): return abs(float(a)-b)<1e-8
       self.assertTrue(same(F(2.4), 2.4))
@@ -1082,7 +1187,7 @@ class Functiontests(casadiTestCase):
 
     grid = [[2, 4, 6]]
     values = [10, 7, 1]
-    for opts in [{"lookup_mode": ["linear"]},{"lookup_mode": ["exact"]},{"lookup_mode": ["binary"]}]:
+    for opts in [{"lookup_mode": ["linear"]},{"lookup_mode": ["exact"]},{"lookup_mode": ["binary"]},{"lookup_mode": ["bucket"]}]:
       F = interpolant('F', 'linear', grid, values, opts)
       def same(a, b): return abs(float(a)-b)<1e-8
       self.assertTrue(same(F(1), 11.5))
@@ -1095,6 +1200,22 @@ class Functiontests(casadiTestCase):
 
       F = interpolant('F', 'linear', [np.linspace(0,1,7)], list(range(7)), {"lookup_mode": ["exact"]})
 
+  def test_1d_interpolant_bucket(self):
+    grid = [np.linspace(0,1,40)**3]
+    values = np.sin(5*grid[0])
+    x = np.hstack([grid[0], np.linspace(-0.3,1.3,101)])
+    for plugin in ["linear","bspline"]:
+      F_ref = interpolant('F', plugin, grid, values, {"lookup_mode": ["linear"]})
+      for opts in [{"lookup_mode": ["bucket"]},{"lookup_mode": ["auto"]}]:
+        F = interpolant('F', plugin, grid, values, opts)
+        self.checkarray(F.map(x.size)(x), F_ref.map(x.size)(x))
+        self.check_codegen(F,inputs=[0.37])
+        self.check_serialize(F,[0.37])
+        xs = MX.sym("x")
+        J = Function('J',[xs],[jacobian(F(xs),xs)])
+        J_ref = Function('J',[xs],[jacobian(F_ref(xs),xs)])
+        self.checkarray(J.map(x.size)(x), J_ref.map(x.size)(x))
+
   def test_2d_interpolant_uniform(self):
     grid = [[0, 1, 2], [0, 1, 2]]
     values = [0, 1, 2, 10, 11, 12, 20, 21, 22]
@@ -1222,6 +1343,24 @@ class Functiontests(casadiTestCase):
       if r is not None:
         self.checkarray(m,r)
 
+  def test_bspline_map(self):
+    np.random.seed(0)
+    d_knots = [list(np.linspace(0,1,5)),list(np.linspace(0,1,6))]
+    data = np.random.random([len(e) for e in d_knots])
+    LUT = casadi.interpolant('name','bspline',d_knots,data.ravel(order='F'))
+
+    N = 7
+    F = LUT.map(N)
+    self.assertTrue(F.is_a("MXFunction"))
+    x = MX.sym("x",2,N)
+    F_ref = Function('F_ref',[x],[horzcat(*[LUT(x[:,i]) for i in range(N)])])
+
+    X = DM(np.random.random((2,N))*1.2-0.1)
+    X[0,:] = np.sort(X[0,:])
+    self.checkfunction(F,F_ref,inputs=[X])
+    self.check_codegen(F,inputs=[X])
+    self.check_serialize(F,inputs=[X])
+
   def test_Callback_Jacobian(self):
     x = MX.sym("x")
     y = MX.sym("y")
@@ -1892,6 +2031,22 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[np.random.random((3,3))])
     self.check_codegen(f,inputs=[np.random.random((3,3))], opts={"avoid_stack": True})
 
+  def test_codegen_batch(self):
+    x = SX.sym("x",3)
+    f = Function('f',[x],[sin(x[0])*x[1]+sq(x[2]),fmin(x[0],x[2])])
+    X = MX.sym("x",3)
+    g = Function('g',[X],[mtimes(DM.rand(2,3),X)+f(X)[0]])
+    for F in [f, g]:
+      for opts in [{"with_batch": True}, {"with_batch": True, "batch_simd": True, "batch_width": 4}]:
+        c = CodeGenerator('me', opts)
+        c.add(F)
+        code = c.dump()
+        self.assertTrue(F.name()+"_batch(" in code)
+        self.assertTrue(F.name()+"_batch_work(" in code)
+        self.check_codegen(F,inputs=[DM([0.3,1.2,-0.7])],opts=opts)
+        # Number of points not divisible by the batch width
+        self.check_codegen_batch(F,opts)
+
 
   def test_serialize(self):
     for opts in [{"debug":True},{}]:
@@ -1966,6 +2121,43 @@ class Functiontests(casadiTestCase):
       fs = Function.deserialize(f.serialize(opts))
       self.checkfunction(f,fs,inputs=[1.1, vertcat(2.7,3)],hessian=False)
 
+  def test_serialize_bulk(self):
+    # Long algorithms, large sparsity patterns and nonzero vectors are written in bulk
+    x = SX.sym("x",500)
+    A = sparsify(DM.rand(500,500)>0.9)*DM.rand(500,500)
+    f = Function('f',[x],[mtimes(A,sin(x))+x[::-1],A])
+    x0 = DM.rand(500)
+    for opts in [{"debug":True},{}]:
+      fs = Function.deserialize(f.serialize(opts))
+      for r, rref in zip(fs(x0),f(x0)):
+        self.checkarray(r, rref, digits=15)
+        self.assertTrue(r.sparsity()==rref.sparsity())
+    As = DM.deserialize(A.serialize())
+    self.assertTrue(As.sparsity()==A.sparsity())
+    self.checkarray(As, A, digits=15)
+
+  def test_save_binary(self):
+    x = SX.sym("x",200)
+    A = sparsify(DM.rand(200,200)>0.9)*DM.rand(200,200)
+    f = Function('f',[x],[mtimes(A,sin(x)),A])
+    xm = MX.sym("x",200)
+    g = Function('g',[xm],[f(xm)[0]*2])
+    x0 = DM.rand(200)
+    for h in [f,g]:
+      for opts in [{"binary":True},{"binary":True,"debug":True},{}]:
+        h.save("save_binary.casadi",opts)
+        hs = Function.load("save_binary.casadi")
+        for r, rref in zip(hs(x0),h(x0)):
+          self.checkarray(r, rref, digits=15)
+          self.assertTrue(r.sparsity()==rref.sparsity())
+
+    # Raw bytes cannot be returned as a string
+    with self.assertInException("Option 'binary' is not supported"):
+      f.serialize({"binary":True})
+    with self.assertInException("Option 'binary' is not supported"):
+      StringSerializer({"binary":True})
+    Function.deserialize(f.serialize({"binary":False}))
+
   @memory_heavy()
   def test_serialize_recursion_limit(self):
       for X in [SX,MX]:
@@ -2072,6 +2264,30 @@ class Functiontests(casadiTestCase):
         self.assertTrue("[[-1e-07]," in out[0] or "[[-1e-007]," in out[0] )
         self.assertTrue("[[1e-07]," in out[0] or "[[1e-007]," in out[0] )
 
+  @requiresPlugin(Importer,"native")
+  def test_jit_native(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    e = [x[0]+y, x[1]-y, x[0]*x[2], x[1]/y, -x[0], fabs(x[1]), x[2]**2, 2*x[0], sqrt(fabs(x[0])),
+         1/x[2], x[0]<x[1], x[0]<=y, x[1]==x[2], x[1]!=x[2], sin(x[0]), exp(y), atan2(x[0],x[1]),
+         fmin(x[0],y), if_else(x[0]<0,x[1],x[2]), 3.5]
+    f = Function('f',[x,y],[vertcat(*e),sin(y)])
+    fj = Function('f',[x,y],[vertcat(*e),sin(y)],{"jit":True,"compiler":"native"})
+    for args in [([0.3,-0.7,1.1],2.0),([-0.2,0.5,0.5],-1.3)]:
+      for r, rj in zip(f.call(args),fj.call(args)):
+        self.checkarray(r,rj,digits=15)
+
+    # No source code is generated
+    if os.path.exists("jit_native_test.c"): os.remove("jit_native_test.c")
+    fj = Function('f',[x,y],[vertcat(*e),sin(y)],{"jit":True,"compiler":"native","jit_name":"jit_native_test","jit_temp_suffix":False})
+    self.assertFalse(os.path.exists("jit_native_test.c"))
+    self.checkarray(fj(0.3,2.0)[1],sin(2.0),digits=15)
+
+    # Only SX functions can be compiled natively
+    x = MX.sym("x")
+    with self.assertRaises(Exception):
+      Function('f',[x],[sin(x)],{"jit":True,"compiler":"native"})
+
   @requires_nlpsol("ipopt")
   @requiresPlugin(Importer,"shell")
   def test_inherit_jit_options(self):
@@ -578,6 +578,44 @@ class casadiTestCase(unittest.TestCase):
       if self.check_serialize:
         self.check_serialize(F2,inputs=inputs)
 
+  def check_codegen_batch(self,F,opts,Ns=[1,7,13,16]):
+    """Compare the batched entry point against the scalar entry point, column by column"""
+    if args.run_slow and os.name!='nt':
+      import hashlib
+      import ctypes
+      name = "codegen_%s" % (hashlib.md5(("%f" % np.random.random()+str(F)+str(time.time())).encode()).hexdigest())
+      F.generate(name, opts)
+      import subprocess
+
+      libdir = GlobalOptions.getCasadiPath()
+      includedir = GlobalOptions.getCasadiIncludePath()
+
+      commands = "gcc -pedantic -std=c89 -fPIC -shared -Wall -Werror -Wextra -I{includedir} -Wno-unknown-pragmas -Wno-long-long -Wno-unused-parameter -O3 {name}.c -o {name}.so -L{libdir}".format(name=name,libdir=libdir,includedir=includedir)
+      p = subprocess.Popen(commands,shell=True).wait()
+
+      F2 = external(F.name(), "./" + name + ".so")
+      lib = ctypes.CDLL("./" + name + ".so")
+      casadi_int = ctypes.c_longlong
+      sz = [casadi_int() for i in range(4)]
+      self.assertEqual(getattr(lib,F.name()+"_batch_work")(*[ctypes.byref(e) for e in sz]),0)
+      [sz_arg, sz_res, sz_iw, sz_w] = [e.value for e in sz]
+
+      for N in Ns:
+        # Nonzero k of point j is stored at k*N+j
+        X = [DM.rand(F.nnz_in(i),N) for i in range(F.n_in())]
+        x = [(ctypes.c_double*(F.nnz_in(i)*N))(*X[i].full().ravel()) for i in range(F.n_in())]
+        r = [(ctypes.c_double*(F.nnz_out(i)*N))() for i in range(F.n_out())]
+        arg = (ctypes.POINTER(ctypes.c_double)*sz_arg)(*[ctypes.cast(e,ctypes.POINTER(ctypes.c_double)) for e in x])
+        res = (ctypes.POINTER(ctypes.c_double)*sz_res)(*[ctypes.cast(e,ctypes.POINTER(ctypes.c_double)) for e in r])
+        iw = (casadi_int*max(sz_iw,1))()
+        w = (ctypes.c_double*max(sz_w,1))()
+        self.assertEqual(getattr(lib,F.name()+"_batch")(arg,res,iw,w,ctypes.c_int(0),casadi_int(N)),0)
+
+        for j in range(N):
+          Fout = F2.call([DM(F.sparsity_in(i),X[i][:,j]) for i in range(F.n_in())])
+          for i in range(F.n_out()):
+            self.checkarray(DM([r[i][k*N+j] for k in range(F.nnz_out(i))]),DM(Fout[i].nonzeros()),digits=15)
+
   def check_thread_safety(self,F,inputs=None,N=20):
     
     FP = F.map(N, 'thread',2)
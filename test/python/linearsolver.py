@@ -84,6 +84,7 @@ except:
 try:
   load_linsol("ldl")
   lsolvers.append(("ldl",{},{"posdef","symmetry"}))
+  lsolvers.append(("ldl",{"supernodal":True},{"posdef","symmetry"}))
 except:
   pass
 
@@ -460,6 +461,111 @@ class LinearSolverTests(casadiTestCase):
 
         self.checkarray(mtimes(A_,f_out),b,digits=digits)
 
+  def test_many_rhs(self):
+    # Right-hand-sides are solved for in blocks
+    numpy.random.seed(1)
+    n = 10
+    A = self.randDM(n,n,sparsity=0.5)
+    A = mtimes(A.T, A) + n*DM.eye(n)
+    for Solver in ["ldl", "qr"]:
+      for nrhs in [1, 8, 19]:
+        b = self.randDM(n,nrhs)
+        C = solve(A,b,Solver)
+        for j in range(nrhs):
+          self.checkarray(C[:,j],solve(A,b[:,j],Solver),digits=12)
+        As = MX.sym("A",A.sparsity())
+        bs = MX.sym("B",b.sparsity())
+        f = Function("f", [As,bs],[solve(As,bs,Solver),solve(As.T,bs,Solver)])
+        self.checkarray(mtimes(A,f(A,b)[0]),b,digits=10)
+        self.check_codegen(f,inputs=[A,b])
+
+  def test_reuse(self):
+    # Factorization of an earlier matrix is kept while iterative refinement converges
+    numpy.random.seed(1)
+    n = 10
+    A0 = self.randDM(n,n,sparsity=0.5)
+    A0 = mtimes(A0.T, A0) + n*DM.eye(n)
+    for Solver in ["ldl", "qr"]:
+      As = MX.sym("A",A0.sparsity())
+      bs = MX.sym("b",n)
+      f = Function("f", [As,bs],[solve(As,bs,Solver,{"reuse_tol":1e-12})])
+      for k in range(5):
+        A = A0 + (10 if k==3 else 1e-3*k)*DM(A0.sparsity(),1)
+        b = self.randDM(n,1)
+        self.checkarray(mtimes(A,f(A,b)),b,digits=10)
+      self.check_serialize(f,inputs=[A0,DM.ones(n)])
+
+  def test_parallel_solve(self):
+    # Level-scheduled triangular solves
+    numpy.random.seed(1)
+    n = 30
+    A = self.randDM(n,n,sparsity=0.2)
+    A = mtimes(A.T, A) + n*DM.eye(n)
+    b = self.randDM(n,11)
+    for Solver in ["ldl", "qr"]:
+      ref = solve(A,b,Solver,{"parallel_solve_nnz":-1})
+      C = solve(A,b,Solver,{"parallel_solve_nnz":0})
+      self.checkarray(ref,C,digits=12)
+      As = MX.sym("A",A.sparsity())
+      bs = MX.sym("b",b.sparsity())
+      f = Function("f", [As,bs],[solve(As,bs,Solver,{"parallel_solve_nnz":0}),
+                                  solve(As.T,bs,Solver,{"parallel_solve_nnz":0})])
+      self.checkarray(f(A,b)[0],ref,digits=12)
+      self.check_serialize(f,inputs=[A,b])
+
+    # Block diagonal: levels with one unknown per block, distributed over threads
+    nb = 100
+    A = diagcat(*[self.randDM(3,3,sparsity=1)+6*DM.eye(3) for i in range(nb)])
+    A = sparsify(mtimes(A.T,A))
+    b = self.randDM(3*nb,3)
+    num_threads = GlobalOptions.getNumThreads()
+    try:
+      GlobalOptions.setNumThreads(4)
+      for Solver in ["ldl", "qr"]:
+        ref = solve(A,b,Solver,{"parallel_solve_nnz":-1})
+        C = solve(A,b,Solver,{"parallel_solve_nnz":0})
+        self.checkarray(ref,C,digits=12)
+        self.checkarray(mtimes(A,C),b,digits=10)
+        As = MX.sym("A",A.sparsity())
+        f = Function("f", [As],[solve(As.T,b,Solver,{"parallel_solve_nnz":0})])
+        self.checkarray(mtimes(A.T,f(A)),b,digits=10)
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+
+  def test_ldl_supernodal(self):
+    # Block tridiagonal, with dense blocks as in multiple shooting
+    numpy.random.seed(1)
+    N = 6
+    nb = 4
+    A = DM.zeros(N*nb,N*nb)
+    for k in range(N):
+      B = DM(numpy.random.random((nb,nb)))
+      A[k*nb:(k+1)*nb,k*nb:(k+1)*nb] = B+B.T+2*nb*DM.eye(nb)
+      if k+1<N:
+        C = DM(numpy.random.random((nb,nb)))
+        A[(k+1)*nb:(k+2)*nb,k*nb:(k+1)*nb] = C
+        A[k*nb:(k+1)*nb,(k+1)*nb:(k+2)*nb] = C.T
+    A = sparsify(A)
+    b = DM(numpy.random.random((N*nb,2)))
+
+    [Lt,p,s] = A.sparsity().ldl_super()
+    self.assertTrue(s.size2()<N*nb)
+    self.assertEqual(Lt.nnz(),A.sparsity().ldl()[0].nnz())
+
+    ref = solve(A,b,"ldl")
+    C = solve(A,b,"ldl",{"supernodal":True})
+    self.checkarray(ref,C,digits=12)
+
+    As = MX.sym("A",A.sparsity())
+    bs = MX.sym("b",b.sparsity())
+    f = Function("f",[As,bs],[solve(As,bs,"ldl",{"supernodal":True})])
+    self.checkarray(f(A,b),ref,digits=12)
+    self.check_codegen(f,inputs=[A,b])
+    self.check_serialize(f,inputs=[A,b])
+
+    with self.assertRaises(Exception):
+      solve(A,b,"ldl",{"supernodal":True,"incomplete":True})
+
   def test_dimmismatch(self):
     A = DM.eye(5)
     b = DM.ones((4,1))
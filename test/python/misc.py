@@ -30,6 +30,7 @@ from helpers import *
 import pickle
 from operator import itemgetter
 import sys
+import os
 from casadi.tools import capture_stdout
 
 scipy_available = True
@@ -526,5 +527,137 @@ class Misctests(casadiTestCase):
     self.assertTrue("t_proc_total" in solver.stats())
     self.assertTrue(solver.stats()["t_proc_total"]>=0)
 
+  def test_import_nl(self):
+    import struct
+    header = """3 1 1 0\t# problem nl_test
+ 2 1 1 0 0\t# vars, constraints, objectives, ranges, eqns
+ 1 1\t# nonlinear constraints, objectives
+ 0 0\t# network constraints: nonlinear, linear
+ 2 2 2\t# nonlinear vars in constraints, objectives, both
+ 0 0 0 1\t# linear network variables; functions; arith, flags
+ 0 0 0 0 0\t# discrete variables: binary, integer, nonlinear (b,c,o)
+ 2 2\t# nonzeros in Jacobian, gradients
+ 0 0\t# max name lengths: constraints, variables
+ 0 0 0 0 0\t# common exprs: b,c,o,c1,o1
+"""
+    # g0 = x0*x1 + sin(x0) + 0.5*x0 + 2*x1, f = x0^2 + x1^2 + 0.25*x0 + 1e-3*x1
+    text = "g" + header + """C0\t#c0
+o0\t#+
+o2\t#*
+v0\t#x0
+v1\t#x1
+o41\t#sin
+v0\t#x0
+O0 0\t#obj
+o54\t#sumlist
+2
+o5\t#^
+v0\t#x0
+n2
+o5\t#^
+v1\t#x1
+n2
+x2\t# initial guess
+0 0.5
+1 -1.5
+r\t#1 ranges (rhs's)
+0 -1 1
+b\t#2 bounds (on variables)
+0 -10 10
+3
+k1\t#intermediate Jacobian column lengths
+1
+J0 2
+0 0.5
+1 2
+G0 2
+0 0.25
+1 1e-3
+"""
+    def c(k): return k.encode()
+    def i(*v): return struct.pack("%di" % len(v), *v)
+    def d(*v): return struct.pack("%dd" % len(v), *v)
+    binary = ("b" + header).encode()
+    binary += c("C") + i(0) + c("o") + i(0) + c("o") + i(2) + c("v") + i(0) + c("v") + i(1)
+    binary += c("o") + i(41) + c("v") + i(0)
+    binary += c("O") + i(0, 0) + c("o") + i(54) + i(2)
+    binary += c("o") + i(5) + c("v") + i(0) + c("n") + d(2)
+    binary += c("o") + i(5) + c("v") + i(1) + c("s") + struct.pack("h", 2)
+    binary += c("x") + i(2) + i(0) + d(0.5) + i(1) + d(-1.5)
+    binary += c("r") + c("0") + d(-1, 1)
+    binary += c("b") + c("0") + d(-10, 10) + c("3")
+    binary += c("k") + i(1) + i(1)
+    binary += c("J") + i(0, 2) + i(0) + d(0.5) + i(1) + d(2)
+    binary += c("G") + i(0, 2) + i(0) + d(0.25) + i(1) + d(1e-3)
+
+    x0 = [0.3, -0.7]
+    for fname, content in [("nl_test_g.nl", text.encode()), ("nl_test_b.nl", binary)]:
+      with open(fname, "wb") as f:
+        f.write(content)
+      nl = NlpBuilder()
+      nl.import_nl(fname)
+      F = Function("F", [vertcat(*nl.x)], [nl.f, vertcat(*nl.g)])
+      f, g = F(x0)
+      self.checkarray(f, x0[0]**2 + x0[1]**2 + 0.25*x0[0] + 1e-3*x0[1])
+      self.checkarray(g, x0[0]*x0[1] + sin(x0[0]) + 0.5*x0[0] + 2*x0[1])
+      self.checkarray(DM(nl.x_init), DM([0.5, -1.5]))
+      self.checkarray(DM(nl.x_lb), DM([-10, -inf]))
+      self.checkarray(DM(nl.x_ub), DM([10, inf]))
+      self.checkarray(DM(nl.g_lb), DM([-1]))
+      self.checkarray(DM(nl.g_ub), DM([1]))
+      os.remove(fname)
+
+  def test_import_nl_chunks(self):
+    import struct
+    # Text files larger than the 1 MB tokenizer chunks, tokenized in several batches
+    N = 20000
+    header = """%d 0 1 0 0\t# vars, constraints, objectives, ranges, eqns
+ 0 1\t# nonlinear constraints, objectives
+ 0 0\t# network constraints: nonlinear, linear
+ 0 %d 0\t# nonlinear vars in constraints, objectives, both
+ 0 0 0 1\t# linear network variables; functions; arith, flags
+ 0 0 0 0 0\t# discrete variables: binary, integer, nonlinear (b,c,o)
+ 0 %d\t# nonzeros in Jacobian, gradients
+ 0 0\t# max name lengths: constraints, variables
+ 0 0 0 0 0\t# common exprs: b,c,o,c1,o1
+""" % (N, N, N)
+    # f = sum_j x_j^2 + 1e-3*(j+1)*x_j, padded with comments
+    pad = "\t#" + 50*"-" + "\n"
+    text = ["g3 1 1 0\t# problem nl_chunks\n", header, "O0 0\no54\n%d\n" % N]
+    text += ["o5" + pad + "v%d" % j + pad + "n2" + pad for j in range(N)]
+    text += ["x%d\n" % N] + ["%d %.17g\n" % (j, 1e-4*j) for j in range(N)]
+    text += ["G0 %d\n" % N] + ["%d %.17g" % (j, 1e-3*(j+1)) + pad for j in range(N)]
+    text = "".join(text).encode()
+    self.assertTrue(len(text)>4*2**20)
+
+    def c(k): return k.encode()
+    def i(*v): return struct.pack("%di" % len(v), *v)
+    def d(*v): return struct.pack("%dd" % len(v), *v)
+    binary = [("b3 1 1 0\t# problem nl_chunks\n" + header).encode()]
+    binary += [c("O") + i(0, 0) + c("o") + i(54) + i(N)]
+    binary += [c("o") + i(5) + c("v") + i(j) + c("n") + d(2) for j in range(N)]
+    binary += [c("x") + i(N)] + [i(j) + d(1e-4*j) for j in range(N)]
+    binary += [c("G") + i(0, N)] + [i(j) + d(1e-3*(j+1)) for j in range(N)]
+    binary = b"".join(binary)
+
+    x0 = numpy.sin(numpy.arange(N))
+    fref = numpy.sum(x0**2 + 1e-3*numpy.arange(1,N+1)*x0)
+    num_threads = GlobalOptions.getNumThreads()
+    try:
+      for fname, content in [("nl_chunks_g.nl", text), ("nl_chunks_b.nl", binary)]:
+        with open(fname, "wb") as f:
+          f.write(content)
+        for t in [1, 4]:
+          GlobalOptions.setNumThreads(t)
+          nl = NlpBuilder()
+          nl.import_nl(fname)
+          self.assertEqual(len(nl.x), N)
+          F = Function("F", [vertcat(*nl.x)], [nl.f])
+          self.checkarray(F(x0), fref, digits=8)
+          self.checkarray(DM(nl.x_init), DM(1e-4*numpy.arange(N)))
+        os.remove(fname)
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+
 if __name__ == '__main__':
     unittest.main()
@@ -2487,6 +2487,44 @@ class MXtests(casadiTestCase):
 
         einstein_tests([2,4,3], [2,5,3], [5, 4], [-1, -2, -3], [-1, -4, -3], [-4, -2])
 
+        # Contractions evaluated with the dense matrix product kernel
+        einstein_tests([4,5], [5,3], [4,3], [-1, -2], [-2, -3], [-1, -3])
+        einstein_tests([5,3], [4,5], [4,3], [-2, -3], [-1, -2], [-1, -3])
+        einstein_tests([4,5,2], [5,3,2], [4,3,2], [-1, -2, -4], [-2, -3, -4], [-1, -3, -4])
+        einstein_tests([4,5], [5], [4], [-1, -2], [-2], [-1])
+        einstein_tests([4], [3], [4,3], [-1], [-2], [-1, -2])
+        # Loops that are merged
+        einstein_tests([3,4,5], [5], [3,4], [-1, -2, -3], [-3], [-1, -2])
+        einstein_tests([3,4,2], [3,4,2], [2], [-1, -2, -3], [-1, -2, -3], [-3])
+
+  def test_einstein_threads(self):
+    # Large enough to be distributed over threads, by outer loop and by column
+    for m, k, n, nb in [(32,32,32,8),(64,64,64,1)]:
+      A = MX.sym("A", m*k*nb)
+      B = MX.sym("B", k*n*nb)
+      C = MX.sym("C", m*n*nb)
+      if nb>1:
+        e = casadi.einstein(A, B, C, [m,k,nb], [k,n,nb], [m,n,nb], [-1,-2,-4], [-2,-3,-4], [-1,-3,-4])
+      else:
+        e = casadi.einstein(A, B, C, [m,k], [k,n], [m,n], [-1,-2], [-2,-3], [-1,-3])
+      f = Function("f",[A,B,C],[e])
+      A_ = DM.rand(m*k*nb)
+      B_ = DM.rand(k*n*nb)
+      C_ = DM.rand(m*n*nb)
+      num_threads = GlobalOptions.getNumThreads()
+      try:
+        GlobalOptions.setNumThreads(1)
+        ref = f(A_,B_,C_)
+        GlobalOptions.setNumThreads(4)
+        r = f(A_,B_,C_)
+      finally:
+        GlobalOptions.setNumThreads(num_threads)
+      self.checkarray(r,ref,digits=12)
+      for l in range(nb):
+        Al = reshape(A_[l*m*k:(l+1)*m*k],m,k)
+        Bl = reshape(B_[l*k*n:(l+1)*k*n],k,n)
+        self.checkarray(r[l*m*n:(l+1)*m*n],C_[l*m*n:(l+1)*m*n]+vec(mtimes(Al,Bl)),digits=12)
+
   def test_sparsity_operation(self):
     L = [MX(Sparsity(1,1)),MX(Sparsity(2,1)), MX.sym("x",1,1), MX.sym("x", Sparsity(1,1)), DM(1), DM(Sparsity(1,1),1), DM(Sparsity(2,1),1), DM(Sparsity.dense(2,1),1)]
 
@@ -2895,6 +2933,76 @@ class MXtests(casadiTestCase):
     i = DM([[0,3],[1,2]])
     self.checkarray(i,A[i].mapping())
 
+  def test_task_parallel(self):
+    y = SX.sym("y",4)
+    g = Function("g",[y],[sin(y)*dot(y,y),cos(y)])
+    x = MX.sym("x",4)
+    A = MX.sym("A",4,4)
+    e = 0
+    for i in range(6):
+      [a,b] = g(x*(i+1))
+      e = 2*e + solve(A+(i+3)*MX.eye(4),a) + b
+    [a,b] = g(e)
+    [c,d] = g(2*e)
+    f = Function("f",[x,A],[a+d,e])
+    fp = Function("f",[x,A],[a+d,e],{"task_parallel":True})
+    x0 = DM.rand(4)
+    A0 = DM.rand(4,4)
+    for fs in [fp, Function.deserialize(fp.serialize())]:
+      for r, rref in zip(fs(x0,A0),f(x0,A0)):
+        self.checkarray(r,rref,digits=15)
+    self.check_codegen(fp,inputs=[x0,A0])
+
+    # Work vector of an input reused after a parallel stage
+    y = SX.sym("y",2)
+    f = Function("f",[y],[sin(y)+y*y])
+    h = Function("h",[y],[cos(y)*y])
+    x = MX.sym("x",2)
+    e = h(f(x))*(2*f(x))
+    x0 = DM([0.3,0.7])
+    fs = Function("f",[x],[e])
+    fp = Function("f",[x],[e],{"task_parallel":True})
+    self.checkarray(fp(x0),fs(x0),digits=15)
+    self.checkarray(fp.expand()(x0),fs(x0),digits=15)
+    self.checkarray(fp.jacobian()(x0,0),fs.jacobian()(x0,0),digits=15)
+    self.checkfunction(fp,fs,inputs=[x0])
+    self.check_codegen(fp,inputs=[x0])
+
+  def test_task_parallel_nested(self):
+    # ThreadMap evaluated from within a parallel stage
+    y = SX.sym("y",3)
+    g = Function("g",[y],[sin(y)*dot(y,y)])
+    gm = g.map(16,"thread",4)
+    x = MX.sym("x",3,16)
+    e = 0
+    for i in range(6):
+      e = e + gm(x*(i+1))
+    fs = Function("f",[x],[e])
+    fp = Function("f",[x],[e],{"task_parallel":True})
+    x0 = DM.rand(3,16)
+    num_threads = GlobalOptions.getNumThreads()
+    try:
+      GlobalOptions.setNumThreads(4)
+      for i in range(20):
+        self.checkarray(fp(x0),fs(x0),digits=15)
+    finally:
+      GlobalOptions.setNumThreads(num_threads)
+
+  def test_dense_mtimes(self):
+    for (m,n,p) in [(1,1,1),(3,5,2),(7,9,13),(70,300,6)]:
+      x = MX.sym("x",m,n)
+      y = MX.sym("y",n,p)
+      z = MX.sym("z",m,p)
+      f = Function("f",[x,y,z],[mac(x,y,z)])
+      x0 = DM.rand(m,n)
+      y0 = DM.rand(n,p)
+      z0 = DM.rand(m,p)
+      ref = z0 + mtimes(densify(x0),densify(y0))
+      self.checkarray(f(x0,y0,z0),ref,digits=12)
+      self.checkarray(f.expand()(x0,y0,z0),ref,digits=12)
+      self.checkarray(mac(x0,y0,z0),ref,digits=12)
+      self.check_codegen(f,inputs=[x0,y0,z0])
+
     
 if __name__ == '__main__':
     unittest.main()
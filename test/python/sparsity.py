@@ -567,6 +567,15 @@ class Sparsitytests(casadiTestCase):
         self.assertTrue(L.is_subset(R))
         self.assertFalse(R.is_subset(L))
 
+  def test_cache_stats(self):
+      a = Sparsity.banded(17,2)
+      stats = Sparsity.cache_stats()
+      b = Sparsity.banded(17,2)
+      self.assertEqual(a.__hash__(),b.__hash__())
+      stats2 = Sparsity.cache_stats()
+      self.assertTrue(stats2["hits"]>stats["hits"])
+      self.assertTrue(stats2["n_alive"]<=stats2["size"])
+      self.assertTrue(stats2["n_shards"]>0)
 
 
 if __name__ == '__main__':
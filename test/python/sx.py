@@ -1426,6 +1426,62 @@ class SXtests(casadiTestCase):
     with self.assertInException("since variables [x] are free"):
       evalf(x)
 
+  def test_fuse_instructions(self):
+    x = SX.sym("x",3)
+
+    e = [x[0]*x[1]+x[2], x[0]*x[1]-x[2], x[2]-x[0]*x[1], x[0]*x[0]+3,
+         2-x[1], x[1]-2, 3*x[2], x[0]/4, 4/x[0], x[1]**3, x[2]**2.5+x[0]*sin(x[1])]
+    for live_variables in [True, False]:
+      opts = {"live_variables": live_variables}
+      f = Function("f",[x],[vertcat(*e),e[0]],opts)
+      opts["fuse_instructions"] = True
+      g = Function("g",[x],[vertcat(*e),e[0]],opts)
+      x0 = DM([1.1,-0.7,2.3])
+      for r, rref in zip(g(x0), f(x0)):
+        self.checkarray(r, rref, digits=15)
+      g = Function.deserialize(g.serialize())
+      for r, rref in zip(g(x0), f(x0)):
+        self.checkarray(r, rref, digits=15)
+
+  def test_reorder_instructions(self):
+    x = SX.sym("x",64)
+
+    # Depth-first evaluation keeps all sin(x[i]) alive
+    e = 0
+    for i in range(64):
+      e = sin(x[i]) + 0.5*e
+    f = Function("f",[x],[e,x[3]*e])
+    g = Function("g",[x],[e,x[3]*e],{"reorder_instructions": True})
+    self.assertTrue(g.sz_w()<f.sz_w())
+    x0 = DM.rand(64)
+    for r, rref in zip(g(x0), f(x0)):
+      self.checkarray(r, rref, digits=15)
+    g = Function.deserialize(g.serialize())
+    for r, rref in zip(g(x0), f(x0)):
+      self.checkarray(r, rref, digits=15)
+
+  def test_hash_consing(self):
+    x = SX.sym("x",8)
+    def model():
+      e = 0
+      for i in range(8):
+        e += sin(x[i]*x[(i+1)%8]) + cos(x[(i+1)%8]*x[i])
+      return e
+    f = Function("f",[x],[model()])
+    GlobalOptions.setHashConsing(True)
+    try:
+      GlobalOptions.resetHashConsingStats()
+      self.assertTrue(is_equal(sin(x[0]*x[1]),sin(x[1]*x[0])))
+      self.assertEqual(GlobalOptions.getHashConsingHits(),2)
+      g = Function("g",[x],[model()])
+      self.assertTrue(GlobalOptions.getHashConsingHits()>2)
+      self.assertTrue(GlobalOptions.getHashConsingHits()<=GlobalOptions.getHashConsingLookups())
+    finally:
+      GlobalOptions.setHashConsing(False)
+    self.assertTrue(g.n_instructions()<f.n_instructions())
+    x0 = DM.rand(8)
+    self.checkarray(g(x0), f(x0), digits=14)
+
 
 
 